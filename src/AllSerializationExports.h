@@ -15,6 +15,7 @@
 
 #include "logic/syntax/Atom.h"
 #include "logic/syntax/BoolLit.h"
+#include "logic/syntax/Cardinality.h"
 #include "logic/syntax/Conjunction.h"
 #include "logic/syntax/Constant.h"
 #include "logic/syntax/DiamondOp.h"
@@ -48,6 +49,8 @@ void registerAllPELTypes(Archive& ar) {
     ar.template register_type<Variable>();
     ar.template register_type<MCSatSamplePerfectlyStrategy>();
     ar.template register_type<MCSatSampleLiquidlyStrategy>();
+    // registered last so archives written before it existed still load
+    ar.template register_type<Cardinality>();
 }
 
 
@@ -45,11 +45,11 @@ public:
 
     LRUCache(unsigned int maxCapacity=1024);
 
-    void insert(K key, V value);
+    void insert(const K& key, const V& value);
     void insert(const std::pair<K, V>& pair);
-    int count(K key) const {return map_.count(key);}
+    int count(const K& key) const {return map_.count(key);}
     int size() const {return vals_.size();}
-    V get(K key);
+    V get(const K& key);
     void clear();
     unsigned int capacity() const {return maxCapacity_;}
     void setCapacity(unsigned int maxCapacity);
@@ -66,7 +66,7 @@ LRUCache<K,V,C>::LRUCache(unsigned int maxCapacity)
 }
 
 template<typename K, typename V, typename C>
-void LRUCache<K,V,C>::insert(K key, V value) {
+void LRUCache<K,V,C>::insert(const K& key, const V& value) {
     insert(ValuePair(key, value));
 }
 
@@ -74,7 +74,7 @@ template<typename K, typename V, typename C>
 void LRUCache<K,V,C>::insert(const std::pair<K, V>& pair) {
     if (maxCapacity_ == 0) return;
     // check to see if we have something already, if so overwrite
-    K key = pair.first;
+    const K& key = pair.first;
     if (map_.count(key) == 1) {
         typename ValueMap::iterator oldPairIt = map_.find(key);
         typename ValueList::iterator oldVal = oldPairIt->second;
@@ -94,21 +94,14 @@ void LRUCache<K,V,C>::insert(const std::pair<K, V>& pair) {
 }
 
 template<typename K, typename V, typename C>
-V LRUCache<K,V,C>::get(K key) {
+V LRUCache<K,V,C>::get(const K& key) {
     typename ValueMap::iterator oldMapIt = map_.find(key);
     typename ValueList::iterator oldValIt = oldMapIt->second;
-    ValuePair valPair = *oldValIt;
-    if (oldValIt == vals_.begin()) {
-        return valPair.second;
+    // move it to the front; splicing keeps the map's iterator valid
+    if (oldValIt != vals_.begin()) {
+        vals_.splice(vals_.begin(), vals_, oldValIt);
     }
-    // do some rearranging
-    vals_.erase(oldValIt);
-    map_.erase(oldMapIt);
-
-    vals_.push_front(valPair);
-    typename ValueList::iterator valIt = vals_.begin();
-    map_.insert(std::pair<K, typename ValueList::iterator>(key, valIt));
-    return valPair.second;
+    return oldValIt->second;
 }
 
 template<typename K, typename V, typename C>
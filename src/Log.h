@@ -14,6 +14,13 @@
 
 enum LOG_LEVEL {LOG_ERROR, LOG_WARN, LOG_INFO, LOG_DEBUG};
 
+/*
+ * Messages can be logged from several threads at once: each one is built in
+ * its own Log object and written out with a single call to fprintf().  The
+ * log level and FilePolicy::stream() are read without locking, so set them
+ * before starting any threads.
+ */
+
 class FilePolicy {
 public:
     static FILE*& stream() {
@@ -99,13 +106,15 @@ std::ostringstream& Log<T>::get(LOG_LEVEL level) {
 template <class T>
 std::string Log<T>::currentTime() const {
     time_t rawtime;
-    struct tm * timeinfo;
+    struct tm timeinfo;
 
+    // localtime() and asctime() share a static buffer between threads
     time (&rawtime);
-    timeinfo = localtime (&rawtime);
-    std::string timeStr(asctime(timeinfo));
+    localtime_r(&rawtime, &timeinfo);
+    char timeStr[9];
+    strftime(timeStr, sizeof(timeStr), "%H:%M:%S", &timeinfo);
 
-    return timeStr.substr(11,8);    // just get the hour:min:sec
+    return std::string(timeStr);
 }
 
 typedef Log<FilePolicy> FileLog;
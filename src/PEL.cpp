@@ -75,6 +75,9 @@ int main(int argc, char* argv[]) {
             if (vm.count("min")) maxInt.setStart(vm["min"].as<unsigned int>());
             d.setMaxInterval(maxInt);
         }
+        if (d.eliminatedNodes() > 0) {
+            LOG(LOG_INFO) << "simplifying formulas eliminated " << d.eliminatedNodes() << " nodes";
+        }
 
         Model model = d.defaultModel();
 
@@ -101,6 +104,10 @@ int main(int argc, char* argv[]) {
                 LOG_PRINT(LOG_INFO) << "running unit propagation...";
                 d = performUnitPropagation(d);
             }
+            if (vm.count("prune")) {
+                LOG(LOG_INFO) << "pruning formulas against the facts...";
+                d = d.pruneFormulas();
+            }
             double p = vm["prob"].as<double>();
             unsigned int iterations = vm["iterations"].as<unsigned int>();
 
@@ -120,6 +127,7 @@ int main(int argc, char* argv[]) {
             }
             */
             MWSSolver mwsSolver(iterations, p, &d);
+            mwsSolver.setNumThreads(vm["threads"].as<unsigned int>());
             Model maxModel = mwsSolver.run(rng, defModel);
 
             LOG_PRINT(LOG_INFO) << "Best model found: " << std::endl;
@@ -170,6 +178,8 @@ void initConfig(int argc,
         ("iterations,i", po::value<unsigned int>()->default_value(1000), "number of iterations before returning a model")
         ("output,o", po::value<std::string>(), "output model file")
         ("unitProp,u", "perform unit propagation only and exit")
+        ("prune,r", "restrict formulas to where their truth isn't already decided by the facts before searching")
+        ("threads,t", po::value<unsigned int>()->default_value(1), "number of threads to score formulas on")
 //        ("datafile,d", po::value<std::string>(), "log scores from maxwalksat to this file (csv form)")
     ;
 
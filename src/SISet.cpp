@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <boost/foreach.hpp>
 #include <iterator>
+#include <vector>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/bernoulli_distribution.hpp>
 #include <boost/random/uniform_int.hpp>
@@ -71,9 +72,9 @@ SISet SISet::compliment() const {
                 }
             }
         }
-        if (!intersected.empty()) {
-            intersections.push_front(intersected);
-        }
+        // nothing is outside every member, so the compliment is empty
+        if (intersected.empty()) return SISet(forceLiquid_, maxInterval_);
+        intersections.push_front(intersected);
     }
     if (intersections.empty()) {
         return SISet(forceLiquid_, maxInterval_);
@@ -97,6 +98,14 @@ unsigned int SISet::size() const {
     return sum;
 }
 
+unsigned int SISet::disjointSize() const {
+    unsigned int sum = 0;
+    for (std::list<SpanInterval>::const_iterator it = set_.begin(); it != set_.end(); it++) {
+        sum += it->size();
+    }
+    return sum;
+}
+
 unsigned int SISet::liqSize() const {
     SISet copy(*this);
     copy.makeDisjoint();
@@ -530,6 +539,232 @@ SISet composedOf(const SpanInterval& i, const SpanInterval& j, Interval::INTERVA
     return spanned;
 }
 
+SISet composedOf(const SISet& a,
+        const SISet& b,
+        const std::set<Interval::INTERVAL_RELATION>& rels,
+        const SpanInterval& universe) {
+    SISet result(false, universe.start());
+    if (a.begin() == a.end() || b.begin() == b.end()) return result;
+
+    // sort b by the earliest start of each span interval, remembering how
+    // wide the widest start range is so we know how far back to look
+    std::vector<const SpanInterval*> bSpans;
+    std::vector<std::pair<unsigned int, std::size_t> > byStart;
+    unsigned int widest = 0;
+    for (SISet::const_iterator it = b.begin(); it != b.end(); it++) {
+        byStart.push_back(std::make_pair(it->start().start(), bSpans.size()));
+        bSpans.push_back(&(*it));
+        if (it->start().finish() > it->start().start()) {
+            widest = std::max(widest, it->start().finish() - it->start().start());
+        }
+    }
+    std::sort(byStart.begin(), byStart.end());
+    std::vector<Interval::INTERVAL_RELATION> relations(rels.begin(), rels.end());
+
+    // (position in b, position in relations) for the current member of a
+    std::vector<std::pair<std::size_t, std::size_t> > candidates;
+    for (SISet::const_iterator aIt = a.begin(); aIt != a.end(); aIt++) {
+        candidates.clear();
+        for (std::size_t r = 0; r < relations.size(); r++) {
+            // anything composed with *aIt has to intersect this
+            boost::optional<SpanInterval> related = aIt->satisfiesRelation(relations[r], universe);
+            if (!related) continue;
+            const SpanInterval& j = *related;
+            unsigned int from = (j.start().start() > widest ? j.start().start() - widest : 0);
+            std::vector<std::pair<unsigned int, std::size_t> >::const_iterator bIt
+                = std::lower_bound(byStart.begin(), byStart.end(), std::make_pair(from, (std::size_t)0));
+            for (; bIt != byStart.end() && bIt->first <= j.start().finish(); bIt++) {
+                const SpanInterval& bSi = *bSpans[bIt->second];
+                if (bSi.start().finish() >= j.start().start()
+                        && bSi.finish().start() <= j.finish().finish()
+                        && bSi.finish().finish() >= j.finish().start()) {
+                    candidates.push_back(std::make_pair(bIt->second, r));
+                }
+            }
+        }
+        // keep the order of the pairwise loop so the result is identical
+        std::sort(candidates.begin(), candidates.end());
+        for (std::vector<std::pair<std::size_t, std::size_t> >::const_iterator cIt = candidates.begin();
+                cIt != candidates.end();
+                cIt++) {
+            result.add(composedOf(*aIt, *bSpans[cIt->first], relations[cIt->second], universe));
+        }
+    }
+    return result;
+}
+
+namespace {
+    bool byFinishThenStart(const SpanInterval& a, const SpanInterval& b) {
+        if (a.finish().start() != b.finish().start()) return a.finish().start() < b.finish().start();
+        if (a.finish().finish() != b.finish().finish()) return a.finish().finish() < b.finish().finish();
+        return a.start().start() < b.start().start();
+    }
+}
+
+SISet sequenceOf(const std::vector<SISet>& parts, const SpanInterval& universe) {
+    if (parts.empty()) throw std::invalid_argument("sequenceOf() requires at least one part");
+    std::set<Interval::INTERVAL_RELATION> meets;
+    meets.insert(Interval::MEETS);
+
+    SISet frontier = parts[0];
+    frontier.setForceLiquid(false);
+    std::vector<SpanInterval> spans;
+    for (std::size_t i = 1; i < parts.size(); i++) {
+        SISet next = parts[i];
+        next.setForceLiquid(false);
+        SISet composed = composedOf(frontier, next, meets, universe);
+
+        // merge span intervals with the same finish range whose start
+        // ranges touch; their union is exactly the merged span interval
+        spans.assign(composed.begin(), composed.end());
+        std::sort(spans.begin(), spans.end(), byFinishThenStart);
+        frontier = SISet(false, universe.start());
+        std::size_t cur = 0;
+        for (std::size_t j = 1; j <= spans.size(); j++) {
+            if (j < spans.size()
+                    && spans[j].finish() == spans[cur].finish()
+                    && spans[j].start().start() <= spans[cur].start().finish() + 1) {
+                if (spans[j].start().finish() > spans[cur].start().finish()) {
+                    spans[cur].setStart(Interval(spans[cur].start().start(), spans[j].start().finish()));
+                }
+                continue;
+            }
+            if (cur < spans.size()) frontier.add(spans[cur]);
+            cur = j;
+        }
+    }
+    return frontier;
+}
+
+namespace {
+    // the liquid intervals of s within maxInterval, added to out
+    void appendLiquid(const SISet& s, const Interval& maxInterval, std::vector<Interval>& out) {
+        for (SISet::const_iterator it = s.begin(); it != s.end(); it++) {
+            if (!it->isLiquid()) throw std::runtime_error("tried to add a non-liquid SI to a liquid SI");
+            unsigned int from = std::max(it->start().start(), maxInterval.start());
+            unsigned int to = std::min(it->start().finish(), maxInterval.finish());
+            if (from <= to) out.push_back(Interval(from, to));
+        }
+    }
+
+    // sort the intervals and join the ones that overlap or meet
+    void coalesce(std::vector<Interval>& intervals) {
+        std::sort(intervals.begin(), intervals.end());
+        std::size_t last = 0;
+        for (std::size_t i = 1; i < intervals.size(); i++) {
+            if (intervals[i].start() <= intervals[last].finish() + 1) {
+                if (intervals[i].finish() > intervals[last].finish()) {
+                    intervals[last].setFinish(intervals[i].finish());
+                }
+            } else {
+                intervals[++last] = intervals[i];
+            }
+        }
+        if (!intervals.empty()) intervals.resize(last+1);
+    }
+}
+
+SISet unionOf(const std::vector<SISet>& sets, bool forceLiquid, const Interval& maxInterval) {
+    SISet result(forceLiquid, maxInterval);
+    if (!forceLiquid) {
+        for (std::vector<SISet>::const_iterator it = sets.begin(); it != sets.end(); it++) {
+            result.add(*it);
+        }
+        return result;
+    }
+    std::vector<Interval> intervals;
+    for (std::vector<SISet>::const_iterator it = sets.begin(); it != sets.end(); it++) {
+        appendLiquid(*it, maxInterval, intervals);
+    }
+    coalesce(intervals);
+    for (std::vector<Interval>::const_iterator it = intervals.begin(); it != intervals.end(); it++) {
+        result.set_.push_back(SpanInterval(*it));
+    }
+    return result;
+}
+
+SISet intersectionOf(const std::vector<SISet>& sets,
+        const std::vector<SISet>& without,
+        bool forceLiquid,
+        const SpanInterval& universe) {
+    if (sets.empty() && without.empty()) throw std::invalid_argument("intersectionOf() requires at least one set");
+    Interval maxInterval = universe.start();
+    if (!forceLiquid) {
+        std::set<Interval::INTERVAL_RELATION> equals;
+        equals.insert(Interval::EQUALS);
+        SISet result(SpanInterval(maxInterval), false, maxInterval);
+        if (!sets.empty()) {
+            result = sets[0];
+            result.setForceLiquid(false);
+        }
+        for (std::size_t i = 1; i < sets.size(); i++) {
+            result = composedOf(result, sets[i], equals, universe);
+        }
+        for (std::vector<SISet>::const_iterator it = without.begin(); it != without.end(); it++) {
+            for (SISet::const_iterator wIt = it->begin(); wIt != it->end() && !result.set_.empty(); wIt++) {
+                result.subtract(*wIt);
+            }
+        }
+        return result;
+    }
+
+    std::vector<Interval> acc, next, merged;
+    if (sets.empty()) acc.push_back(maxInterval);
+    else appendLiquid(sets[0], maxInterval, acc);
+    coalesce(acc);
+    for (std::size_t i = 1; i < sets.size() && !acc.empty(); i++) {
+        next.clear();
+        appendLiquid(sets[i], maxInterval, next);
+        coalesce(next);
+
+        // both are sorted and disjoint, so walk them together
+        merged.clear();
+        std::size_t a = 0, b = 0;
+        while (a < acc.size() && b < next.size()) {
+            unsigned int from = std::max(acc[a].start(), next[b].start());
+            unsigned int to = std::min(acc[a].finish(), next[b].finish());
+            if (from <= to) merged.push_back(Interval(from, to));
+            if (acc[a].finish() < next[b].finish()) a++;
+            else b++;
+        }
+        acc.swap(merged);
+    }
+
+    if (!without.empty() && !acc.empty()) {
+        next.clear();
+        for (std::vector<SISet>::const_iterator it = without.begin(); it != without.end(); it++) {
+            appendLiquid(*it, maxInterval, next);
+        }
+        coalesce(next);
+
+        // keep the gaps between the intervals to take out
+        merged.clear();
+        std::size_t b = 0;
+        for (std::size_t a = 0; a < acc.size(); a++) {
+            unsigned int from = acc[a].start();
+            bool covered = false;
+            while (b < next.size() && next[b].finish() < from) b++;
+            while (b < next.size() && next[b].start() <= acc[a].finish()) {
+                if (next[b].start() > from) merged.push_back(Interval(from, next[b].start()-1));
+                if (next[b].finish() >= acc[a].finish()) {
+                    covered = true;
+                    break;
+                }
+                from = next[b].finish()+1;
+                b++;
+            }
+            if (!covered) merged.push_back(Interval(from, acc[a].finish()));
+        }
+        acc.swap(merged);
+    }
+
+    SISet result(true, maxInterval);
+    for (std::vector<Interval>::const_iterator it = acc.begin(); it != acc.end(); it++) {
+        result.set_.push_back(SpanInterval(*it));
+    }
+    return result;
+}
+
 bool equalByInterval(const SISet& a, const SISet& b) {
     // this is expensive
     std::set<Interval> aIntervals;
@@ -9,6 +9,8 @@
 #define SISET_H_
 #include <set>
 #include <list>
+#include <vector>
+#include <algorithm>
 #include <iostream>
 #include "SpanInterval.h"
 #include <boost/functional/hash.hpp>
@@ -43,6 +45,11 @@ public:
     SISet compliment() const;
     Interval maxInterval() const;
     unsigned int size() const;
+    /**
+     * Same as size(), for a set already known to be disjoint (such as the
+     * result of makeDisjoint()); skips making a disjoint copy first.
+     */
+    unsigned int disjointSize() const;
     unsigned int liqSize() const;
     bool empty() const;
     const std::list<SpanInterval>& intervals() const {return set_;}
@@ -53,6 +60,7 @@ public:
 
     void makeDisjoint();
     void clear() {set_.clear();};
+    void swap(SISet& b);
     void setMaxInterval(const Interval& maxInterval);
     void setForceLiquid(bool forceLiquid);
     void subtract(const SpanInterval& si);
@@ -94,6 +102,11 @@ public:
     friend SISet intersection(const SISet& a, const SpanInterval& si);
     friend SISet span(const SpanInterval& a, const SpanInterval& b, const Interval& maxInterval);
     friend bool equalByInterval(const SISet& a, const SISet& b);
+    friend SISet unionOf(const std::vector<SISet>& sets, bool forceLiquid, const Interval& maxInterval);
+    friend SISet intersectionOf(const std::vector<SISet>& sets,
+            const std::vector<SISet>& without,
+            bool forceLiquid,
+            const SpanInterval& universe);
     friend std::size_t hash_value(const SISet& si);
 private:
     friend class boost::serialization::access;
@@ -149,8 +162,79 @@ private:
 
 SISet span(const SpanInterval& a, const SpanInterval& b, const Interval& maxInterval);
 SISet composedOf(const SpanInterval& a, const SpanInterval& b, Interval::INTERVAL_RELATION, const SpanInterval& universe);
+
+/**
+ * Compose every pair of span intervals from a and b under every relation in
+ * rels, the way a non-liquid conjunction does.  Equivalent to adding
+ * composedOf(x, y, rel, universe) for each x in a, y in b and rel in rels
+ * (in that order), but pairs that can't satisfy any of the relations are
+ * skipped: b is sorted by start, and for each x only the members of b
+ * whose endpoints fall in x.satisfiesRelation(rel) are composed.
+ *
+ * @param a         the left hand side
+ * @param b         the right hand side
+ * @param rels      the relations that may hold between them
+ * @param universe  the (liquid) max span interval
+ * @return  a non-liquid set over universe.start()
+ */
+SISet composedOf(const SISet& a,
+        const SISet& b,
+        const std::set<Interval::INTERVAL_RELATION>& rels,
+        const SpanInterval& universe);
+/**
+ * Compose a sequence of sets under MEETS, the way a chain of non-liquid
+ * "a ; b ; c ; ..." conjunctions does.  Gives the same intervals as
+ * composing the parts pairwise with composedOf(), but the prefix is
+ * carried left to right as a frontier: after each step, span intervals
+ * ending in the same finish range are merged into one whose start range
+ * covers them all.  Only the frontier is joined against the next part, so
+ * it stays about as large as the parts instead of growing with every step.
+ * Since composedOf() is approximate, composing the merged span intervals
+ * with anything else can give different intervals than composing the
+ * pairwise ones would, so only use this where nothing composes the result.
+ *
+ * @param parts     the sets in order; must not be empty
+ * @param universe  the (liquid) max span interval
+ * @return  a non-liquid set over universe.start()
+ */
+SISet sequenceOf(const std::vector<SISet>& parts, const SpanInterval& universe);
 bool equalByInterval(const SISet& a, const SISet& b);
 
+/**
+ * The union of several sets, the way a chain of disjunctions adds them up.
+ * Non-liquid sets are simply appended.  Liquid ones are merged in a single
+ * sorted pass instead of one add() at a time, so the result comes out
+ * sorted with touching intervals joined.
+ *
+ * @param sets         the sets to join; liquid ones must only hold liquid
+ *   span intervals
+ * @param forceLiquid  whether the result (and the sets) are liquid
+ * @param maxInterval  the max interval of the result
+ */
+SISet unionOf(const std::vector<SISet>& sets, bool forceLiquid, const Interval& maxInterval);
+
+/**
+ * The intersection of several sets, the way a chain of "^" conjunctions
+ * intersects them.  Liquid sets are sorted once and intersected with a
+ * linear merge of their intervals.  Non-liquid sets are composed with
+ * composedOf() under EQUALS, from left to right.
+ *
+ * Negated operands can be given in without rather than as their
+ * compliment(), which can be far bigger than the set itself; they are
+ * subtracted from the intersection of the rest (or from the whole
+ * timeline, if sets is empty).
+ *
+ * @param sets         the sets to intersect
+ * @param without      sets whose compliments are also intersected
+ * @param forceLiquid  whether the result (and the sets) are liquid
+ * @param universe     the (liquid) max span interval
+ */
+SISet intersectionOf(const std::vector<SISet>& sets,
+        const std::vector<SISet>& without,
+        bool forceLiquid,
+        const SpanInterval& universe);
+SISet intersectionOf(const std::vector<SISet>& sets, bool forceLiquid, const SpanInterval& universe);
+
 unsigned long hammingDistance(const SISet& a, const SISet& b);
 
 // IMPLEMENTATION
@@ -158,6 +242,16 @@ inline SISet::const_iterator SISet::begin() const {return set_.begin();}
 inline SISet::const_iterator SISet::end() const {return set_.end();}
 inline bool SISet::empty() const { return size() == 0;}
 
+inline SISet intersectionOf(const std::vector<SISet>& sets, bool forceLiquid, const SpanInterval& universe) {
+    return intersectionOf(sets, std::vector<SISet>(), forceLiquid, universe);
+}
+
+inline void SISet::swap(SISet& b) {
+    std::swap(set_, b.set_);
+    std::swap(forceLiquid_, b.forceLiquid_);
+    std::swap(maxInterval_, b.maxInterval_);
+}
+
 
 inline bool SISet::includes(const SISet& s) const {
     SISet copy = s;
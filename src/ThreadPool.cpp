@@ -0,0 +1,92 @@
+/*
+ * ThreadPool.cpp
+ */
+
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(std::size_t numThreads)
+    : threads_(), mutex_(), wake_(), done_(), task_(0), numItems_(0), next_(0),
+      busy_(0), generation_(0), stopping_(false), error_(), failed_(false) {
+    for (std::size_t i = 1; i < numThreads; i++) {
+        threads_.create_thread(boost::bind(&ThreadPool::work, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    threads_.join_all();
+}
+
+void ThreadPool::run(std::size_t numItems, const Task& task) {
+    if (numItems == 0) return;
+    if (threads_.size() == 0 || numItems == 1) {
+        for (std::size_t i = 0; i < numItems; i++) task(0, i);
+        return;
+    }
+
+    {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        task_ = &task;
+        numItems_ = numItems;
+        next_ = 0;
+        busy_ = threads_.size();
+        error_.clear();
+        failed_ = false;
+        generation_++;
+    }
+    wake_.notify_all();
+    runItems(0);
+
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    while (busy_ > 0) done_.wait(lock);
+    task_ = 0;
+    if (failed_) throw std::runtime_error(error_);
+}
+
+void ThreadPool::work(std::size_t worker) {
+    unsigned long seen = 0;
+    for (;;) {
+        {
+            boost::unique_lock<boost::mutex> lock(mutex_);
+            while (!stopping_ && generation_ == seen) wake_.wait(lock);
+            if (stopping_) return;
+            seen = generation_;
+        }
+        runItems(worker);
+        {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            busy_--;
+        }
+        done_.notify_one();
+    }
+}
+
+void ThreadPool::runItems(std::size_t worker) {
+    for (;;) {
+        std::size_t item;
+        {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            if (next_ >= numItems_) return;
+            item = next_++;
+        }
+        try {
+            (*task_)(worker, item);
+        } catch (std::exception& e) {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            if (!failed_) error_ = e.what();
+            failed_ = true;
+            next_ = numItems_;
+        } catch (...) {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            if (!failed_) error_ = "ThreadPool::run(): task threw an unknown exception";
+            failed_ = true;
+            next_ = numItems_;
+        }
+    }
+}
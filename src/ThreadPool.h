@@ -0,0 +1,91 @@
+/*
+ * ThreadPool.h
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <cstddef>
+#include <string>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/utility.hpp>
+
+/**
+ * A fixed set of worker threads for running independent tasks in parallel.
+ *
+ * run() hands out the items 0..n-1 to the workers (the calling thread is
+ * one of them) and returns once every item is done.  Items are claimed one
+ * at a time, so which worker runs an item is not fixed; tasks should write
+ * their results into a slot for their item and leave combining them to the
+ * caller, which keeps the result independent of the number of threads.
+ *
+ * The worker number passed to a task is less than size() and is never used
+ * by two threads at the same time, so it can index per-worker scratch space.
+ *
+ * A pool is not reentrant: run() must not be called from inside a task or
+ * from two threads at once.
+ */
+class ThreadPool : boost::noncopyable {
+public:
+    /**
+     * A task, called with the number of the worker running it and the item
+     * to process.
+     */
+    typedef boost::function<void (std::size_t worker, std::size_t item)> Task;
+
+    /**
+     * Start a pool.
+     *
+     * @param numThreads  how many threads run() should use, counting the
+     *   calling thread; 0 is treated as 1 (everything runs on the caller)
+     */
+    explicit ThreadPool(std::size_t numThreads);
+
+    /**
+     * Stop and join the worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * Get the number of threads tasks run on, counting the calling thread.
+     */
+    std::size_t size() const;
+
+    /**
+     * Run task on every item from 0 to numItems-1 and wait for them all to
+     * finish.  If a task throws, the remaining items are skipped.  When
+     * everything ran on the calling thread the exception is passed on as
+     * is; otherwise a std::runtime_error with the first error's message is
+     * thrown once the workers have stopped.
+     *
+     * @param numItems  how many items to process
+     * @param task      the task to run on each of them
+     */
+    void run(std::size_t numItems, const Task& task);
+private:
+    // the main loop of worker threads
+    void work(std::size_t worker);
+    // claim and process items until there are none left
+    void runItems(std::size_t worker);
+
+    boost::thread_group threads_;
+    boost::mutex mutex_;
+    boost::condition_variable wake_;    // a new run has started (or stop)
+    boost::condition_variable done_;    // a worker finished its part of a run
+    const Task* task_;
+    std::size_t numItems_;
+    std::size_t next_;          // the next unclaimed item
+    std::size_t busy_;          // workers still on the current run
+    unsigned long generation_;  // incremented for every run
+    bool stopping_;
+    std::string error_;
+    bool failed_;
+};
+
+// IMPLEMENTATION
+inline std::size_t ThreadPool::size() const { return threads_.size()+1;}
+
+#endif /* THREADPOOL_H_ */
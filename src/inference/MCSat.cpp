@@ -78,16 +78,12 @@ void MCSat::run(boost::mt19937& rng) { // TODO: setup using random initial model
 //            std::cin.get();
 //        }
 
-        // make a new domain using new Sentences
-        Domain curDomain;
-        curDomain.setMaxInterval(prevDomain.maxInterval());
-        for (Domain::fact_const_iterator it = prevDomain.facts_begin(); it != prevDomain.facts_end(); it++) {
-            curDomain.addFact(*it);
-        }
-        for (std::vector<ELSentence>::const_iterator it = newSentences.begin(); it != newSentences.end(); it++) {
-            curDomain.addFormula(*it);
-        }
-        curDomain.addAtoms(prevDomain.atoms_begin(), prevDomain.atoms_end());
+        // make a new domain using new Sentences; it shares prevDomain's
+        // facts and atoms, so only the sampled formulas are copied
+        Domain curDomain = prevDomain;
+        curDomain.setDontModifyObsPreds(true);
+        curDomain.clearFormulas();
+        curDomain.addFormulas(newSentences.begin(), newSentences.end());
 //
 //        if (iteration == burnInIterations_ + numSamples_/2) {
 //            std::cout << "ITERATION: " << iteration << std::endl;
@@ -127,10 +123,11 @@ Domain MCSat::applyUP(const Domain& d) {
     // default model is guaranteed to satisfy the facts
     Model m = reduced.defaultModel();
     // check to make sure hard clauses are satisfied
-    std::vector<ELSentence> hardClauses;
-    std::remove_copy_if(reduced.formulas_begin(), reduced.formulas_end(), std::back_inserter(hardClauses), std::not1(IsHardClausePred()));
-    for (std::vector<ELSentence>::const_iterator it = hardClauses.begin(); it != hardClauses.end(); it++) {
-        if (!it->fullySatisfied(m, reduced)) {
+    SentenceProgram::Registers regs;
+    IsHardClausePred isHardClause;
+    for (std::size_t i = 0; i < reduced.formulas_size(); i++) {
+        if (!isHardClause(reduced.formulas_begin()[i])) continue;
+        if (!reduced.isFullySatisfied(i, m, regs)) {
             throw contradiction("Contradiction found in MCSat::run() when verifying hard clauses are satisfied");
         }
     }
@@ -173,20 +170,21 @@ void MCSatSampleSegmentsStrategy::sampleSentences(const Model& m, const Domain&
 */
 
 boost::unordered_set<Model> MCSat::sampleSat(const Model& initialModel, const Domain& d, boost::mt19937& rng) {
+    // hashing/equality on Model go through its incrementally maintained
+    // fingerprint, so deduplicating candidates here is O(1) per insert
+    // unless two models actually collide
     boost::unordered_set<Model> models;
     models.insert(initialModel); // always include the initial model
 
-    // transform domain into a SAT problem
-    Domain dSat;
-    for (Domain::fact_const_iterator it = d.facts_begin(); it != d.facts_end(); it++) {
-        dSat.addFact(*it);
-    }
+    // transform domain into a SAT problem (sharing d's facts and atoms)
+    Domain dSat = d;
+    dSat.setDontModifyObsPreds(true);
+    dSat.clearFormulas();
     for (Domain::formula_const_iterator it = d.formulas_begin(); it != d.formulas_end(); it++) {
         ELSentence s = *it;
         s.setHasInfWeight(true);
         dSat.addFormula(s);
     }
-    dSat.addAtoms(d.atoms_begin(), d.atoms_end());
     // perform UP (if possible)
     Domain reduced;
     if (useUnitPropagation_) {
@@ -23,14 +23,15 @@ MCSatSampleLiquidlyStrategy::~MCSatSampleLiquidlyStrategy() {
 
 void MCSatSampleLiquidlyStrategy::sampleSentences(const Model& m, const Domain& d, boost::mt19937& rng, std::vector<ELSentence>& sampled) {
     // sample on an interval basis for each formula, enforcing liquid constraints
-    for (Domain::formula_const_iterator it = d.formulas_begin(); it != d.formulas_end(); it++) {
-        ELSentence curSentence = *it;
+    SentenceProgram::Registers regs;
+    for (std::size_t i = 0; i < d.formulas_size(); i++) {
+        ELSentence curSentence = d.formulas_begin()[i];
 
         if (curSentence.hasInfWeight()) {
             sampled.push_back(curSentence); // have to take it
             continue;
         }
-        SISet satisfied = curSentence.dSatisfied(m, d);
+        SISet satisfied = d.dSatisfied(i, m, regs);
         
         // TODO by Jun: Do we need to change satisfied to be force_liquid
 
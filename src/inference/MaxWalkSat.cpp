@@ -9,6 +9,7 @@
 #include "../logic/syntax/ELSentence.h"
 #include "../logic/Domain.h"
 #include "../logic/Moves.h"
+#include "../ThreadPool.h"
 #include <boost/random/uniform_int.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/unordered_map.hpp>
@@ -16,6 +17,23 @@
 
 const unsigned int MWSSolver::defNumIterations = 1000;
 const double MWSSolver::defProbOfRandomMove = 0.2;
+const unsigned int MWSSolver::defCacheCapacity = 4096;
+
+unsigned int MWSSolver::numThreads() const {
+    return (pool_ ? pool_->size() : 1);
+}
+
+void MWSSolver::setNumThreads(unsigned int numThreads) {
+    if (numThreads <= 1) {
+        pool_.reset();
+        workerRegisters_.clear();
+        workerCaches_.clear();
+        return;
+    }
+    pool_.reset(new ThreadPool(numThreads));
+    workerRegisters_.assign(numThreads-1, SentenceProgram::Registers());
+    workerCaches_.assign(numThreads-1, SentenceProgram::Cache(defCacheCapacity));
+}
 
 Model MWSSolver::run(boost::mt19937& rng) {
     if (domain_ == NULL) {
@@ -33,10 +51,12 @@ struct MWSState {
     Move move;
     Model model;
     double score;
-    // the three below here are copies of the versions above
-    std::vector<bool> localFormNeedUpdates;
+    // the formulas the move changes and their results after it; the others
+    // are left as they are in the current state rather than copied
+    std::vector<std::size_t> rescored;
     std::vector<double> localScores;
     std::vector<bool> localFormFullySat;
+    std::vector<SISet> localFormSats;
 };
 }
 
@@ -46,6 +66,11 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
         std::logic_error e("unable to run MWSSolver with Domain set to null ptr");
         throw e;
     }
+    // cached subformula results are only valid for the domain they came from
+    cache_.clear();
+    for (std::size_t i = 0; i < workerCaches_.size(); i++) {
+        workerCaches_[i].clear();
+    }
     // copy the domain's sentences into our own
     std::vector<ELSentence> formulas;
     std::copy(domain_->formulas_begin(), domain_->formulas_end(), std::back_inserter(formulas));
@@ -55,8 +80,9 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
         return initialModel;
     }
 
-    // now note which sentences have valid moves
-    std::vector<bool> formWithMoves(formulas.size(), false);
+    // now work out how to generate moves for each sentence, once
+    std::vector<MoveGenerator> generators;
+    generators.reserve(formulas.size());
     for (std::vector<ELSentence>::size_type i = 0;
             i < formulas.size();
             i++) {
@@ -65,36 +91,21 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
             std::logic_error e("unable to deal with infinitely weighted sentences.");
             throw e;
         }
-        if (!canFindMovesFor(*formulas[i].sentence(), *domain_)) {
+        generators.push_back(MoveGenerator(*formulas[i].sentence(), *domain_));
+        if (!generators.back().canFindMoves()) {
             LOG(LOG_WARN) << "currently cannot generate moves for sentence: \"" << formulas[i].sentence()->toString() << "\".  ignoring it for generating moves";
-            formWithMoves[i] = false;
-        } else {
-            formWithMoves[i] = true;
-        }
-    }
-
-    // now record which sentences contain each atom - this is used to cache
-    // the results of previous satisfied sentences.
-    boost::unordered_map<Atom, std::vector<std::vector<ELSentence>::size_type > > atomToSentence;
-    for (std::vector<ELSentence>::size_type i = 0;
-            i != formulas.size();
-            i++) {
-        AtomCollector collector;
-        formulas[i].sentence()->visit(collector);
-        for (AtomCollector::atom_set::const_iterator atomit = collector.atoms.begin();
-                atomit != collector.atoms.end();
-                atomit++) {
-            atomToSentence[*atomit].push_back(i);
         }
     }
 
     // setup stores for the score as well as whether each sentence is fully satisfied
     std::vector<double> formScores(formulas.size(), 0.0);
     std::vector<bool> formFullySat(formulas.size(), false);
+    // and where each one is satisfied, so moves can be scored incrementally
+    std::vector<SISet> formSats(formulas.size());
     // also setup a vector we will use to mark which scores need updating
     std::vector<bool> formNeedUpdates(formulas.size(), true);
 
-    updateScores(formulas, initialModel, formNeedUpdates, formScores, formFullySat);
+    updateScores(formulas, initialModel, formNeedUpdates, formScores, formFullySat, formSats, NULL);
 
     double currentScore = std::accumulate(formScores.begin(), formScores.end(), 0.0);
     double bestScore = currentScore;
@@ -122,7 +133,7 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
                 i++) {
             if (!formFullySat[i]) {
                 noImprovementLeft = false;
-                if (formWithMoves[i]) {
+                if (generators[i].canFindMoves()) {
                     formCandidates.push_back(i);
                 }
             }
@@ -146,15 +157,9 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
         if (formCandidates.empty()) {
             LOG(LOG_WARN) << "cannot generate any moves for the current model (not all formulas are currently handled) - generating a random move";
             // pick a random atom
-            boost::uniform_int<std::size_t> atomPick(0, domain_->atoms_size()-1);
-            std::size_t atomInd = atomPick(rng);
-            Domain::atom_const_iterator atomIt = domain_->atoms_begin();
-            while (atomInd > 0) {
-                atomIt++;
-                atomInd--;
-            }
-
-            Atom atom = *atomIt;
+            boost::uniform_int<Domain::atom_id> atomPick(0, domain_->atoms_size()-1);
+            Domain::atom_id atomId = atomPick(rng);
+            const Atom& atom = domain_->atomById(atomId);
             // now pick a spanning interval
 
             Interval maxInterval = domain_->maxInterval();
@@ -170,23 +175,23 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
                 si = SpanInterval(start, start, finish, finish);
             }
             // make a random flip to add/subtract
-            Move::change ch(atom, si);
             boost::bernoulli_distribution<> flip(0.5);
             if (flip(rng)) {
-                nextMove.toAdd.push_back(ch);
+                nextMove.add(atomId, si);
             } else {
-                nextMove.toDel.push_back(ch);
+                nextMove.del(atomId, si);
             }
         } else {
             // choose a formula to improve at random
             boost::uniform_int<std::size_t> formulaPick(0, formCandidates.size()-1);
             std::size_t formChoseInd = formulaPick(rng);
-            ELSentence formula = formulas[formCandidates[formChoseInd]];
+            std::size_t formInd = formCandidates[formChoseInd];
+            const ELSentence& formula = formulas[formInd];
             LOG(LOG_DEBUG) << "choosing formula: " << formula << " to improve.";
 
 
             // find the moves for it
-            std::vector<Move> moves = findMovesFor(*domain_, currentModel, formula, rng);
+            std::vector<Move> moves = generators[formInd].findMoves(*domain_, currentModel, formInd, rng);
             if (moves.size() == 0) {
 
                 LOG(LOG_WARN) << "WARNING: unable to find moves for sentence " << formula.sentence()->toString()
@@ -197,7 +202,7 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
                 std::ostringstream vecStream;
                 for (std::vector<Move>::const_iterator it = moves.begin(); it != moves.end(); it++) {
                     if (it != moves.begin()) vecStream << ", ";
-                    vecStream << "(" << it->toString() << ")";
+                    vecStream << "(" << it->toString(*domain_) << ")";
                 }
                 LOG(LOG_DEBUG) << "moves to consider: " << vecStream.str();
             }
@@ -207,11 +212,11 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
                 // take a random move
                 boost::uniform_int<std::size_t> movesPick(0, moves.size()-1);
                 Move aMove = moves[movesPick(rng)];
-                LOG(LOG_DEBUG) << "taking random move: " << aMove.toString();
+                LOG(LOG_DEBUG) << "taking random move: " << aMove.toString(*domain_);
 
-                currentModel = updateWithMove(aMove, currentModel, atomToSentence, formNeedUpdates);
+                currentModel = updateWithMove(aMove, currentModel, formNeedUpdates);
                 // update scores
-                updateScores(formulas, currentModel, formNeedUpdates, formScores, formFullySat);
+                updateScores(formulas, currentModel, formNeedUpdates, formScores, formFullySat, formSats, &aMove);
                 currentScore = std::accumulate(formScores.begin(), formScores.end(), 0.0);
             } else {
                 // instead of choosing a random move, choose the move that leads to the
@@ -227,51 +232,66 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
 
                 //std::vector<std::pair<Model, double> > nearbyModels;
                 for (std::vector<Move>::const_iterator it = moves.begin(); it != moves.end(); it++) {
-                    Move m = *it;
+                    const Move& m = *it;
                     std::vector<bool> localFormNeedUpdates(formNeedUpdates);
-                    Model nearbyModel = updateWithMove(m, currentModel, atomToSentence, localFormNeedUpdates);
+                    MWSState state;
+                    state.model = updateWithMove(m, currentModel, localFormNeedUpdates);
 
-                    std::vector<double> localScores(formScores);
-                    std::vector<bool> localFormFullySat(formFullySat);
-                    updateScores(formulas, nearbyModel, localFormNeedUpdates, localScores, localFormFullySat);
-                    double nearbyScore = std::accumulate(localScores.begin(), localScores.end(), 0.0);
+                    // only rescore (and copy the results of) the formulas the move touches
+                    for (std::size_t i = 0; i < localFormNeedUpdates.size(); i++) {
+                        if (localFormNeedUpdates[i]) state.rescored.push_back(i);
+                    }
+                    std::vector<SISet*> sats;
+                    state.localFormSats.reserve(state.rescored.size());
+                    for (std::size_t k = 0; k < state.rescored.size(); k++) {
+                        state.localFormSats.push_back(formSats[state.rescored[k]]);
+                    }
+                    for (std::size_t k = 0; k < state.rescored.size(); k++) {
+                        sats.push_back(&state.localFormSats[k]);
+                    }
+                    std::vector<SentenceProgram::Count> counts;
+                    scoreFormulas(formulas, state.model, state.rescored, sats, &m, counts);
+
+                    // total in formula order, as for the current model
+                    state.score = 0.0;
+                    for (std::size_t i = 0, k = 0; i < formScores.size(); i++) {
+                        if (k < state.rescored.size() && state.rescored[k] == i) {
+                            state.localScores.push_back(((double)counts[k].satisfied) * formulas[i].weight());
+                            state.localFormFullySat.push_back(counts[k].fullySatisfied());
+                            state.score += state.localScores[k++];
+                        } else {
+                            state.score += formScores[i];
+                        }
+                    }
 
-                    if (nearbyScore > bestMWSState.score) {
+                    if (state.score > bestMWSState.score) {
                         // save it
-                        bestMWSState.move = m;
-                        bestMWSState.model = nearbyModel;
-                        bestMWSState.score = nearbyScore;
-                        bestMWSState.localFormNeedUpdates = localFormNeedUpdates;
-                        bestMWSState.localScores = localScores;
-                        bestMWSState.localFormFullySat = localFormFullySat;
-
+                        state.move = m;
+                        bestMWSState = state;
                         ties.clear();
                         ties.push_back(bestMWSState);
-                    } else if (nearbyScore == bestMWSState.score) {
+                    } else if (state.score == bestMWSState.score) {
                         // found a tie
-                        MWSState tieState;
-                        tieState.move = m;
-                        tieState.model = nearbyModel;
-                        tieState.score = nearbyScore;
-                        tieState.localFormNeedUpdates = localFormNeedUpdates;
-                        tieState.localScores = localScores;
-                        tieState.localFormFullySat = localFormFullySat;
-
-                        ties.push_back(tieState);
+                        state.move = m;
+                        ties.push_back(state);
                     }
                 }
                 assert(bestMWSState.score > std::numeric_limits<double>::min());
                 if (ties.size() > 1) {
                     // pick a choice randomly
                     boost::uniform_int<std::size_t> tieChoice(0, ties.size()-1);
-                    bestMWSState = ties[tieChoice(rng)];
+                    std::swap(bestMWSState, ties[tieChoice(rng)]);
                 }
-                LOG(LOG_DEBUG) << "taking move " << bestMWSState.move.toString();
+                LOG(LOG_DEBUG) << "taking move " << bestMWSState.move.toString(*domain_);
                 currentModel = bestMWSState.model;
                 currentScore = bestMWSState.score;
-                formNeedUpdates = bestMWSState.localFormNeedUpdates;
-                formScores = bestMWSState.localScores;
-                formFullySat = bestMWSState.localFormFullySat;
+                for (std::size_t k = 0; k < bestMWSState.rescored.size(); k++) {
+                    std::size_t i = bestMWSState.rescored[k];
+                    formScores[i] = bestMWSState.localScores[k];
+                    formFullySat[i] = bestMWSState.localFormFullySat[k];
+                    formSats[i].swap(bestMWSState.localFormSats[k]);
+                    formNeedUpdates[i] = false;
+                }
             }
         }
         // check to see if its the best score foudn so far
@@ -398,40 +418,23 @@ Model MWSSolver::run(boost::mt19937& rng, const Model& initialModel) {
 
 Model MWSSolver::updateWithMove(const Move& m,
         const Model& currentModel,
-        const boost::unordered_map<Atom, std::vector<std::vector<ELSentence>::size_type > >& atomMap,
         std::vector<bool>& formsNeedUpdate) {
     // scan over all atoms in the move - if its being modified, mark the formula as needing update
-    boost::unordered_set<Atom> moveAtoms;
-    for (std::vector<Move::change>::const_iterator it = m.toAdd.begin();
-            it != m.toAdd.end();
-            it++) {
-        moveAtoms.insert(it->get<0>());
-    }
-    for (std::vector<Move::change>::const_iterator it = m.toDel.begin();
-            it != m.toDel.end();
-            it++) {
-        moveAtoms.insert(it->get<0>());
-    }
-
-    for (boost::unordered_set<Atom>::const_iterator it = moveAtoms.begin();
-            it != moveAtoms.end();
-            it++) {
-        Atom a = *it;
-        if (atomMap.count(a)) {
-            // TODO: loop over all sentences
-            std::vector<std::vector<ELSentence>::size_type > formsWithAtom = atomMap.at(a);
-            for (std::vector<std::vector<ELSentence>::size_type >::const_iterator atomIt = formsWithAtom.begin();
-                    atomIt != formsWithAtom.end();
-                    atomIt++) {
-            formsNeedUpdate[*atomIt] = true;
-            }
-        }
+    for (Move::change_const_iterator it = m.changes_begin(); it != m.changes_end(); it++) {
+        markFormulasWithAtom(it->atom, formsNeedUpdate);
     }
 
     // now execute the move
     return executeMove(*domain_, m, currentModel);
 }
 
+void MWSSolver::markFormulasWithAtom(std::size_t atomId, std::vector<bool>& formsNeedUpdate) const {
+    const std::vector<std::size_t>& forms = domain_->formulasWithAtom(atomId);
+    for (std::vector<std::size_t>::const_iterator it = forms.begin(); it != forms.end(); it++) {
+        formsNeedUpdate[*it] = true;
+    }
+}
+
 /*
 Model maxWalkSat(Domain& d,
         int numIterations,
@@ -470,6 +473,7 @@ Model maxWalkSat(Domain& d,
     }
 
     AtomOccurences occurs = findAtomOccurences(formulas);
+    SentenceProgram::Registers regs;
     std::vector<double> formScores;
     double currentScore = 0.0;
     for (unsigned int i = 0; i < formulas.size(); i++) {
@@ -503,9 +507,8 @@ Model maxWalkSat(Domain& d,
         for (std::vector<int>::iterator it = notFullySatisfied.begin(); it != notFullySatisfied.end(); ) {
             int i = *it;
 
-            ELSentence wsent = curFormulas.at(i);
             //const WSentence *wsentence = *it;
-            if (wsent.fullySatisfied(currentModel, d)) {
+            if (d.isFullySatisfied(i, currentModel, regs)) {
                 it = notFullySatisfied.erase(it);
             } else {
                 it++;
@@ -660,51 +663,104 @@ namespace {
 }
 */
 
+struct MWSSolver::ScoreTask {
+    MWSSolver* solver;
+    const std::vector<ELSentence>* formulas;
+    const Model* model;
+    const std::vector<std::size_t>* which;
+    const std::vector<SISet*>* sats;
+    const Move* lastMove;
+    std::vector<SentenceProgram::Count>* counts;
+
+    void operator()(std::size_t worker, std::size_t item) const {
+        std::size_t i = (*which)[item];
+        SentenceProgram::Registers& regs = (worker == 0 ? solver->registers_ : solver->workerRegisters_[worker-1]);
+        SentenceProgram::Cache& cache = (worker == 0 ? solver->cache_ : solver->workerCaches_[worker-1]);
+        (*counts)[item] = solver->scoreFormula(i, (*formulas)[i], *model, *(*sats)[item], lastMove, regs, cache);
+    }
+};
+
 void MWSSolver::updateScores(const std::vector<ELSentence>& formulas,
         const Model& model,
         std::vector<bool>& whichToUpdate,
         std::vector<double>& scores,
-        std::vector<bool>& fullySatisfied) {
-//    std::cout << "in MWSSolver::updateScores()" << std::endl;
-//
-//    std::cout << "fullySatisfied: ";
-//    std::copy(fullySatisfied.begin(), fullySatisfied.end(), std::ostream_iterator<bool>(std::cout, ", "));
-//    std::cout << std::endl;
-
-    // first, calculate all the SISets for our sentences
-    for (std::size_t i = 0;
-            i < whichToUpdate.size();
-            i++) {
-
-        if (!whichToUpdate[i]) {
-//            std::cout << "  asked not to update this formula" << std::endl;
-            continue;    // skip elements that don't need updating
+        std::vector<bool>& fullySatisfied,
+        std::vector<SISet>& sats,
+        const Move* lastMove) {
+    std::vector<std::size_t> which;
+    std::vector<SISet*> whichSats;
+    for (std::size_t i = 0; i < whichToUpdate.size(); i++) {
+        if (whichToUpdate[i]) {
+            which.push_back(i);
+            whichSats.push_back(&sats[i]);
         }
-        ELSentence formula = formulas[i];
+    }
 
-        // find the quantification for the current sentence
-        SISet quantification(domain_->maxSpanInterval(), false, domain_->maxInterval());
-        if (formula.isQuantified()) {
-            quantification = formula.quantification();
-        }
+    std::vector<SentenceProgram::Count> counts;
+    scoreFormulas(formulas, model, which, whichSats, lastMove, counts);
 
-        SISet formSat = formula.dSatisfied(model, *domain_);
+    for (std::size_t k = 0; k < which.size(); k++) {
+        std::size_t i = which[k];
         // next, overwrite the score for the model
-        scores[i] = ((double)formSat.size()) * formula.weight();
+        scores[i] = ((double)counts[k].satisfied) * formulas[i].weight();
         // finally, mark if its completely satisfied
-        SISet leftover = quantification;
-        leftover.subtract(formSat);
-        if (leftover.empty()) {
-            fullySatisfied[i] = true;
-        } else {
-            fullySatisfied[i] = false;
-        }
+        fullySatisfied[i] = counts[k].fullySatisfied();
         // done updating!  make a note
         whichToUpdate[i] = false;
     }
-//    std::cout << "leaving MWSSolver::updateScores()";
-//    std::cout << "fullySatisfied: ";
-//    std::copy(fullySatisfied.begin(), fullySatisfied.end(), std::ostream_iterator<bool>(std::cout, ", "));
-//    std::cout << std::endl;
+}
+
+void MWSSolver::scoreFormulas(const std::vector<ELSentence>& formulas,
+        const Model& model,
+        const std::vector<std::size_t>& which,
+        const std::vector<SISet*>& sats,
+        const Move* lastMove,
+        std::vector<SentenceProgram::Count>& counts) {
+    // the formulas are independent, so they can be scored on any thread;
+    // the counts are returned rather than written to the callers' vectors
+    // since vector<bool> can't be written to from several threads
+    counts.assign(which.size(), SentenceProgram::Count());
+    if (pool_ && which.size() > 1) {
+        ScoreTask task = {this, &formulas, &model, &which, &sats, lastMove, &counts};
+        pool_->run(which.size(), task);
+    } else {
+        for (std::size_t k = 0; k < which.size(); k++) {
+            std::size_t i = which[k];
+            counts[k] = scoreFormula(i, formulas[i], model, *sats[k], lastMove, registers_, cache_);
+        }
+    }
+}
 
+SentenceProgram::Count MWSSolver::scoreFormula(std::size_t i,
+        const ELSentence& formula,
+        const Model& model,
+        SISet& formSat,
+        const Move* lastMove,
+        SentenceProgram::Registers& regs,
+        SentenceProgram::Cache& cache) const {
+    // find the quantification for the current sentence
+    SISet quantification(domain_->maxSpanInterval(), false, domain_->maxInterval());
+    if (formula.isQuantified()) {
+        quantification = formula.quantification();
+    }
+
+    const SentenceProgram& program = domain_->formulaProgram(i);
+    SentenceProgram::Count count;
+    if (!program.hasDelta()) {
+        // nothing to update incrementally, so only the count is needed
+        count = program.count(model, *domain_,
+                (formula.isQuantified() ? &quantification : NULL), regs, &cache);
+    } else {
+        if (lastMove != NULL) {
+            formSat = program.dSatisfiedDelta(model, *domain_, quantification, formSat, *lastMove, regs);
+        } else {
+            formSat = (formula.isQuantified()
+                    ? program.dSatisfied(model, *domain_, quantification, regs, cache)
+                    : program.dSatisfied(model, *domain_, regs, cache));
+        }
+        // formSat is disjoint and lies inside the quantification
+        count.satisfied = formSat.disjointSize();
+        count.total = quantification.size();
+    }
+    return count;
 }
@@ -9,17 +9,20 @@
 #define MAXWALKSAT_H_
 
 #include <boost/random.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/unordered_map.hpp>
 #include <set>
 #include <map>
 #include <vector>
 #include <iostream>
+#include "../logic/syntax/SentenceProgram.h"
 
 class Move;
 class Model;
 class Domain;
 class Atom;
 class ELSentence;
+class ThreadPool;
 //struct AtomStringCompare;
 
 /**
@@ -30,6 +33,7 @@ class MWSSolver {
 public:
     static const unsigned int defNumIterations;
     static const double defProbOfRandomMove;
+    static const unsigned int defCacheCapacity;
 
     /**
      * Construct a MWSSolver with the default settings (and no domain).
@@ -77,6 +81,13 @@ public:
      */
     Domain* domain() const;
 
+    /**
+     * Get the number of threads formula scores are updated on.
+     *
+     * @return  the number of threads, counting the one calling run()
+     */
+    unsigned int numThreads() const;
+
     /**
      * Set the number of iterations that the solver should run for when
      * calling run().
@@ -101,6 +112,16 @@ public:
      */
     void setDomain(Domain* d);
 
+    /**
+     * Set the number of threads to update formula scores on.  With 1 (the
+     * default) everything runs on the thread calling run().  The scores,
+     * and so the search, are the same whatever the number of threads.
+     *
+     * @param numThreads  the number of threads, counting the one calling
+     *   run(); 0 is treated as 1
+     */
+    void setNumThreads(unsigned int numThreads);
+
     /**
      * Run the MaxWalkSat algorithm with the current configuration.  Note that
      * the domain object must not be NULL (or a logic_error exception is thrown).
@@ -123,41 +144,91 @@ public:
      */
     Model run(boost::mt19937& rng, const Model& initialModel);
 private:
-    // update the formula scores and return a list of sentences that are not fully satisfied and have moves
+    // update the formula scores and return a list of sentences that are not fully satisfied and have moves.
+    // sats holds where each formula is satisfied; if lastMove is given, it is
+    // the only change since sats was computed and is used to re-evaluate
+    // only the part of the timeline it can affect
     void updateScores(const std::vector<ELSentence>& formulas,
             const Model& m,
             std::vector<bool>& whichToUpdate,
             std::vector<double>& scores,
-            std::vector<bool>& fullySatisfied);
+            std::vector<bool>& fullySatisfied,
+            std::vector<SISet>& sats,
+            const Move* lastMove);
+
+    // score the formulas in which on m; *sats[k] holds where formula
+    // which[k] was satisfied before lastMove and is brought up to date
+    void scoreFormulas(const std::vector<ELSentence>& formulas,
+            const Model& m,
+            const std::vector<std::size_t>& which,
+            const std::vector<SISet*>& sats,
+            const Move* lastMove,
+            std::vector<SentenceProgram::Count>& counts);
+
+    // score formula i on model, bringing formSat up to date if the formula
+    // is updated incrementally
+    SentenceProgram::Count scoreFormula(std::size_t i,
+            const ELSentence& formula,
+            const Model& model,
+            SISet& formSat,
+            const Move* lastMove,
+            SentenceProgram::Registers& regs,
+            SentenceProgram::Cache& cache) const;
+
+    // scores the formulas of scoreFormulas() on a worker of pool_
+    struct ScoreTask;
 
     // execute a move, updating all sentences that need scores updating at the same time
     Model updateWithMove(const Move& m,
             const Model& currentModel,
-            const boost::unordered_map<Atom, std::vector<std::vector<ELSentence>::size_type > >& atomMap,
             std::vector<bool>& formsNeedUpdate);
 
+    // mark every formula of the domain containing an atom as needing an update
+    void markFormulasWithAtom(std::size_t atomId, std::vector<bool>& formsNeedUpdate) const;
+
     unsigned int numIterations_;
     double probOfRandomMove_;
     Domain* domain_;
+    SentenceProgram::Registers registers_;  // scratch space for formula programs
+    SentenceProgram::Cache cache_;          // subformula results, per run
+    boost::shared_ptr<ThreadPool> pool_;    // NULL when running on one thread
+    // scratch space and caches for the workers of pool_ other than the caller
+    std::vector<SentenceProgram::Registers> workerRegisters_;
+    std::vector<SentenceProgram::Cache> workerCaches_;
 };
 
 // IMPLEMENTATION
 inline MWSSolver::MWSSolver()
     : numIterations_(defNumIterations),
       probOfRandomMove_(defProbOfRandomMove),
-      domain_(NULL) {}
+      domain_(NULL),
+      registers_(),
+      cache_(defCacheCapacity),
+      pool_(),
+      workerRegisters_(),
+      workerCaches_() {}
 
 inline MWSSolver::MWSSolver(Domain* d)
     : numIterations_(defNumIterations),
       probOfRandomMove_(defProbOfRandomMove),
-      domain_(d) {};
+      domain_(d),
+      registers_(),
+      cache_(defCacheCapacity),
+      pool_(),
+      workerRegisters_(),
+      workerCaches_() {};
 
 inline MWSSolver::MWSSolver(unsigned int numIterations,
         double probOfRandomMove,
         Domain* d)
     : numIterations_(numIterations),
       probOfRandomMove_(probOfRandomMove),
-      domain_(d) {
+      domain_(d),
+      registers_(),
+      cache_(defCacheCapacity),
+      pool_(),
+      workerRegisters_(),
+      workerCaches_() {
     if (probOfRandomMove < 0.0 || probOfRandomMove > 1.0) {
         std::logic_error e("probOfRandomMove is out of range for MWSSolver");
         throw e;
@@ -0,0 +1,110 @@
+/*
+ * CompressedTimeline.cpp
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "CompressedTimeline.h"
+#include "Domain.h"
+#include "Model.h"
+
+CompressedTimeline::CompressedTimeline(const Domain& d)
+    : frames_(d.maxInterval()), cuts_() {
+    if (frames_.isNull()) return;
+
+    std::vector<unsigned int> cuts;
+    cuts.push_back(frames_.start());
+    for (Domain::fact_const_iterator it = d.facts_begin(); it != d.facts_end(); it++) {
+        addBoundaries(it->second, cuts);
+    }
+    for (Domain::formula_const_iterator it = d.formulas_begin(); it != d.formulas_end(); it++) {
+        if (it->isQuantified()) addBoundaries(it->quantification(), cuts);
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+    cuts_.swap(cuts);
+}
+
+void CompressedTimeline::addBoundaries(const SISet& set, std::vector<unsigned int>& cuts) const {
+    // a segment starts at the beginning of each endpoint range, and right
+    // after its end
+    for (SISet::const_iterator it = set.begin(); it != set.end(); it++) {
+        const unsigned int points[4] = {it->start().start(), it->start().finish()+1,
+                it->finish().start(), it->finish().finish()+1};
+        for (int i = 0; i < 4; i++) {
+            if (points[i] > frames_.start() && points[i] <= frames_.finish()) cuts.push_back(points[i]);
+        }
+    }
+}
+
+Interval CompressedTimeline::maxInterval() const {
+    if (cuts_.empty()) return Interval();
+    return Interval(frames_.start(), frames_.start() + cuts_.size() - 1);
+}
+
+Interval CompressedTimeline::segment(unsigned int point) const {
+    if (cuts_.empty() || point < frames_.start() || point - frames_.start() >= cuts_.size()) {
+        throw std::out_of_range("CompressedTimeline::segment() - point is not on the compressed timeline");
+    }
+    std::size_t i = point - frames_.start();
+    unsigned int last = (i+1 < cuts_.size() ? cuts_[i+1]-1 : frames_.finish());
+    return Interval(cuts_[i], last);
+}
+
+unsigned int CompressedTimeline::compress(unsigned int frame) const {
+    if (cuts_.empty()) throw std::logic_error("CompressedTimeline::compress() - timeline is empty");
+    std::vector<unsigned int>::const_iterator it = std::upper_bound(cuts_.begin(), cuts_.end(), frame);
+    if (it == cuts_.begin()) return frames_.start();
+    return frames_.start() + ((it - cuts_.begin()) - 1);
+}
+
+SpanInterval CompressedTimeline::compress(const SpanInterval& si) const {
+    return SpanInterval(compress(si.start().start()), compress(si.start().finish()),
+            compress(si.finish().start()), compress(si.finish().finish()));
+}
+
+SISet CompressedTimeline::compress(const SISet& set) const {
+    SISet compressed(set.forceLiquid(), maxInterval());
+    for (SISet::const_iterator it = set.begin(); it != set.end(); it++) {
+        compressed.add(compress(*it));
+    }
+    return compressed;
+}
+
+Domain CompressedTimeline::compress(const Domain& d) const {
+    Domain compressed;
+    compressed.setDontModifyObsPreds(d.dontModifyObsPreds());
+    if (cuts_.empty()) return compressed;
+    compressed.setMaxInterval(maxInterval());
+    for (Domain::fact_const_iterator it = d.facts_begin(); it != d.facts_end(); it++) {
+        compressed.addFact(it->first, compress(it->second));
+    }
+    for (Domain::formula_const_iterator it = d.formulas_begin(); it != d.formulas_end(); it++) {
+        ELSentence formula = *it;
+        if (formula.isQuantified()) formula.setQuantification(compress(formula.quantification()));
+        compressed.addFormula(formula);
+    }
+    compressed.addAtoms(d.atoms_begin(), d.atoms_end());
+    return compressed;
+}
+
+SpanInterval CompressedTimeline::expand(const SpanInterval& si) const {
+    return SpanInterval(segment(si.start().start()).start(), segment(si.start().finish()).finish(),
+            segment(si.finish().start()).start(), segment(si.finish().finish()).finish());
+}
+
+SISet CompressedTimeline::expand(const SISet& set) const {
+    SISet expanded(set.forceLiquid(), frames_);
+    for (SISet::const_iterator it = set.begin(); it != set.end(); it++) {
+        expanded.add(expand(*it));
+    }
+    return expanded;
+}
+
+Model CompressedTimeline::expand(const Model& m) const {
+    Model expanded(frames_);
+    for (Model::const_iterator it = m.begin(); it != m.end(); it++) {
+        expanded.setAtom(it->first, expand(it->second));
+    }
+    return expanded;
+}
@@ -0,0 +1,121 @@
+/*
+ * CompressedTimeline.h
+ */
+
+#ifndef COMPRESSEDTIMELINE_H_
+#define COMPRESSEDTIMELINE_H_
+
+#include <vector>
+#include "../Interval.h"
+#include "../SpanInterval.h"
+#include "../SISet.h"
+
+class Domain;
+class Model;
+
+/**
+ * A mapping from a domain's frames onto a compressed timeline.
+ *
+ * The frames of the max interval are split into segments at every boundary
+ * of a fact or formula quantification, so every fact and quantification is
+ * a union of whole segments.  Each segment becomes a single time point on
+ * the compressed timeline, which starts at the same point as the original.
+ * Allen relations between segment-aligned intervals are preserved, so
+ * MaxWalkSat/MCSat can be run on compress(d) and the resulting models mapped
+ * back with expand().
+ *
+ * Scores on the compressed domain count segments rather than frames, so
+ * the search is an approximation of the search over frames: a model found
+ * on the compressed timeline can't change value part way through a
+ * segment, and long segments weigh the same as short ones.
+ *
+ * Compressing rarely makes inference faster: sentences are evaluated on
+ * span intervals, and the number of those doesn't depend on how many frames
+ * they cover, while building the compressed domain re-adds every formula.
+ * On the recipe and basketball datasets MaxWalkSat was slower with it, so
+ * the inference tools don't use it.
+ */
+class CompressedTimeline {
+public:
+    /**
+     * Construct an empty timeline (no segments).
+     */
+    CompressedTimeline();
+
+    /**
+     * Construct the compressed timeline for a domain, using the boundaries
+     * of all its facts and formula quantifications.
+     *
+     * @param d  the domain to compress
+     */
+    explicit CompressedTimeline(const Domain& d);
+
+    /**
+     * Get the number of segments (compressed time points).
+     *
+     * @return  the number of time points on the compressed timeline
+     */
+    std::size_t size() const;
+
+    /**
+     * Get the max interval of the original (frame) timeline.
+     */
+    Interval frameInterval() const;
+
+    /**
+     * Get the max interval of the compressed timeline.
+     */
+    Interval maxInterval() const;
+
+    /**
+     * Get the range of frames covered by a compressed time point.
+     *
+     * @param point  a point in maxInterval()
+     * @return  the frames of the segment it represents
+     */
+    Interval segment(unsigned int point) const;
+
+    /**
+     * Map a frame onto the compressed time point whose segment contains it.
+     * Frames outside frameInterval() are clamped to the nearest segment.
+     */
+    unsigned int compress(unsigned int frame) const;
+
+    SpanInterval compress(const SpanInterval& si) const;
+    SISet compress(const SISet& set) const;
+
+    /**
+     * Build a copy of d (facts, formulas and atoms) with every time
+     * coordinate mapped onto the compressed timeline.
+     *
+     * @param d  the domain this timeline was built from
+     * @return  the compressed domain
+     */
+    Domain compress(const Domain& d) const;
+
+    SpanInterval expand(const SpanInterval& si) const;
+    SISet expand(const SISet& set) const;
+
+    /**
+     * Map a model found on the compressed domain back to frame coordinates.
+     *
+     * @param m  a model over maxInterval()
+     * @return  the same model over frameInterval()
+     */
+    Model expand(const Model& m) const;
+
+private:
+    void addBoundaries(const SISet& set, std::vector<unsigned int>& cuts) const;
+
+    Interval frames_;
+    std::vector<unsigned int> cuts_;    // first frame of each segment, ascending
+};
+
+// IMPLEMENTATION
+inline CompressedTimeline::CompressedTimeline()
+    : frames_(), cuts_() {}
+
+inline std::size_t CompressedTimeline::size() const { return cuts_.size();}
+inline Interval CompressedTimeline::frameInterval() const { return frames_;}
+
+#endif /* COMPRESSEDTIMELINE_H_ */
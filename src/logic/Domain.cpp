@@ -2,11 +2,119 @@
 #include "ELSyntax.h"
 #include "Model.h"
 #include "../Log.h"
+#include "../ThreadPool.h"
 
 #include <boost/shared_ptr.hpp>
 #include <stdexcept>
 #include <sstream>
 #include <vector>
+#include <algorithm>
+
+namespace {
+    const std::vector<std::size_t> noFormulas;
+
+    struct StartFromLess {
+        bool operator()(const SpanInterval& l, const SpanInterval& r) const {
+            return l.start().start() < r.start().start();
+        }
+    };
+
+    // scores one formula into its slot, using the worker's registers
+    struct ScoreFormula {
+        const Domain* d;
+        const Model* m;
+        std::vector<SentenceProgram::Registers>* regs;
+        std::vector<double>* scores;
+
+        void operator()(std::size_t worker, std::size_t i) const {
+            (*scores)[i] = d->score(i, *m, (*regs)[worker]);
+        }
+    };
+
+    // marks the copies of atoms that appear under a negation
+    const char* const negatedSuffix = "~negated";
+
+    Atom negatedCopy(const Atom& a) {
+        Atom renamed(a.name() + negatedSuffix);
+        for (Atom::term_const_iterator it = a.term_begin(); it != a.term_end(); it++) renamed.push_back(*it);
+        return renamed;
+    }
+
+    // copy s, renaming the atoms under an odd number of negations so they
+    // can be given their own values; collects the atoms of either polarity.
+    // Returns an empty pointer if s has a node that isn't monotone in its
+    // operands (other than a negation).
+    boost::shared_ptr<Sentence> polarized(const boost::shared_ptr<Sentence>& s,
+            bool negated,
+            boost::unordered_set<Atom>& positive,
+            boost::unordered_set<Atom>& negative) {
+        boost::shared_ptr<Sentence> none;
+        switch (s->getTypeCode()) {
+        case Atom::TypeCode: {
+            const Atom& a = static_cast<const Atom&>(*s);
+            if (!negated) {
+                positive.insert(a);
+                return s;
+            }
+            negative.insert(a);
+            return boost::shared_ptr<Sentence>(new Atom(negatedCopy(a)));
+        }
+        case BoolLit::TypeCode:
+            return s;
+        case Negation::TypeCode: {
+            boost::shared_ptr<Negation> copy(new Negation(static_cast<const Negation&>(*s)));
+            copy->setSentence(polarized(copy->sentence(), !negated, positive, negative));
+            if (!copy->sentence()) return none;
+            return copy;
+        }
+        case Conjunction::TypeCode: {
+            boost::shared_ptr<Conjunction> copy(new Conjunction(static_cast<const Conjunction&>(*s)));
+            copy->setLeft(polarized(copy->left(), negated, positive, negative));
+            copy->setRight(polarized(copy->right(), negated, positive, negative));
+            if (!copy->left() || !copy->right()) return none;
+            return copy;
+        }
+        case Disjunction::TypeCode: {
+            boost::shared_ptr<Disjunction> copy(new Disjunction(static_cast<const Disjunction&>(*s)));
+            copy->setLeft(polarized(copy->left(), negated, positive, negative));
+            copy->setRight(polarized(copy->right(), negated, positive, negative));
+            if (!copy->left() || !copy->right()) return none;
+            return copy;
+        }
+        case DiamondOp::TypeCode: {
+            boost::shared_ptr<DiamondOp> copy(new DiamondOp(static_cast<const DiamondOp&>(*s)));
+            copy->setSentence(polarized(copy->sentence(), negated, positive, negative));
+            if (!copy->sentence()) return none;
+            return copy;
+        }
+        case LiquidOp::TypeCode: {
+            boost::shared_ptr<LiquidOp> copy(new LiquidOp(static_cast<const LiquidOp&>(*s)));
+            copy->setSentence(polarized(copy->sentence(), negated, positive, negative));
+            if (!copy->sentence()) return none;
+            return copy;
+        }
+        default:
+            return none;
+        }
+    }
+
+    // the least (or greatest) value an atom can take in a model agreeing with
+    // the facts: true only where observed true, or everywhere it isn't
+    // observed false
+    SISet boundOf(const Atom& a, bool greatest, const Domain::PropMap& partialModel, const SpanInterval& universe) {
+        Interval maxInterval(universe.start().start(), universe.finish().finish());
+        Proposition trueAt(a, true);
+        Proposition falseAt(a, false);
+        if (!greatest) {
+            SISet low(true, maxInterval);
+            if (partialModel.count(trueAt) != 0) low.add(partialModel.at(trueAt));
+            return low;
+        }
+        SISet high(universe, true, maxInterval);
+        if (partialModel.count(falseAt) != 0) high.subtract(partialModel.at(falseAt));
+        return high;
+    }
+}
 
 /*
 void Domain::addObservedPredicate(const Atom& a) {
@@ -20,11 +128,13 @@ void swap(Domain& a, Domain& b) {
     using std::swap;
 
     swap(a.dontModifyObsPreds_, b.dontModifyObsPreds_);
-    swap(a.maxInterval_, b.maxInterval_);
+    swap(a.core_, b.core_);
     swap(a.formulas_, b.formulas_);
-    swap(a.partialModel_, b.partialModel_);
-    //swap(a.predTypes_, b.predTypes_);
-    swap(a.allAtoms_, b.allAtoms_);
+    swap(a.formulasWithAtom_, b.formulasWithAtom_);
+    swap(a.atomsInFormula_, b.atomsInFormula_);
+    swap(a.programs_, b.programs_);
+    swap(a.templates_, b.templates_);
+    swap(a.eliminatedNodes_, b.eliminatedNodes_);
     swap(a.generator_, b.generator_);
 }
 
@@ -32,23 +142,150 @@ std::size_t Domain::formulas_size() const {
     return formulas_.size();
 }
 
+const std::vector<std::size_t>& Domain::formulasWithAtom(atom_id atomId) const {
+    if (atomId >= formulasWithAtom_.size()) return noFormulas;
+    return formulasWithAtom_[atomId];
+}
+
+Domain::atom_id Domain::insertAtom(const Atom& a) {
+    boost::unordered_map<Atom, atom_id>::const_iterator it = core_->atomIds.find(a);
+    if (it != core_->atomIds.end()) return it->second;
+
+    Core& core = mutableCore();
+    std::size_t id = core.atomsById.size();
+    core.allAtoms.insert(a);
+    core.atomIds.insert(std::make_pair(a, id));
+    core.atomsById.push_back(a);
+    return id;
+}
+
+void Domain::indexFormula(std::size_t formulaId) {
+    AtomCollector acollect;
+    formulas_[formulaId].sentence()->visit(acollect);
+
+    if (atomsInFormula_.size() <= formulaId) atomsInFormula_.resize(formulaId+1);
+    std::vector<std::size_t>& atoms = atomsInFormula_[formulaId];
+    atoms.clear();
+    for (AtomCollector::atom_set::const_iterator it = acollect.atoms.begin(); it != acollect.atoms.end(); it++) {
+        atom_id atomId = insertAtom(*it);
+        atoms.push_back(atomId);
+        if (formulasWithAtom_.size() <= atomId) formulasWithAtom_.resize(atomId+1);
+        formulasWithAtom_[atomId].push_back(formulaId);
+    }
+    std::sort(atoms.begin(), atoms.end());
+}
+
+void Domain::rebuildAtomIndex() {
+    Core& core = mutableCore();
+    core.atomIds.clear();
+    core.atomsById.clear();
+    for (boost::unordered_set<Atom>::const_iterator it = core.allAtoms.begin(); it != core.allAtoms.end(); it++) {
+        core.atomIds.insert(std::make_pair(*it, core.atomsById.size()));
+        core.atomsById.push_back(*it);
+    }
+    formulasWithAtom_.clear();
+    atomsInFormula_.clear();
+    for (std::size_t i = 0; i < formulas_.size(); i++) {
+        indexFormula(i);
+    }
+}
+
+void Domain::compileFormulas() {
+    programs_.clear();
+    templates_.clear();
+    programs_.reserve(formulas_.size());
+    for (std::size_t i = 0; i < formulas_.size(); i++) {
+        formulas_[i].setSentence(core_->interner->intern(formulas_[i].sentence()));
+        programs_.push_back(SentenceProgram(formulas_[i].sentence()));
+        groupFormula(i);
+    }
+}
+
+void Domain::groupFormula(std::size_t formulaId) {
+    const SentenceProgram& program = programs_[formulaId];
+    for (std::size_t g = 0; g < templates_.size(); g++) {
+        if (programs_[templates_[g].front()].sameShape(program)) {
+            templates_[g].push_back(formulaId);
+            return;
+        }
+    }
+    templates_.push_back(std::vector<std::size_t>(1, formulaId));
+}
+
 SISet Domain::getModifiableSISet(const Atom& a) const {
-    return getModifiableSISet(a, SISet(maxSpanInterval(), true, maxInterval_));
+    return getModifiableSISet(a, SISet(maxSpanInterval(), true, core_->maxInterval));
 }
 
 SISet Domain::getModifiableSISet(const Atom& a, const SISet& where) const {
-    if (!dontModifyObsPreds_) {
+    if (!dontModifyObsPreds_ || core_->fixedRegions.count(a) == 0) {
         return where;
     }
+    const PropMap& partialModel = core_->partialModel;
     SISet modifiable = where;
     Proposition trueAt(a, true);
     Proposition falseAt(a, false);
-    if (partialModel_.count(trueAt) != 0) modifiable.subtract(partialModel_.at(trueAt));
-    if (partialModel_.count(falseAt) != 0) modifiable.subtract(partialModel_.at(falseAt));
+    if (partialModel.count(trueAt) != 0) modifiable.subtract(partialModel.at(trueAt));
+    if (partialModel.count(falseAt) != 0) modifiable.subtract(partialModel.at(falseAt));
 
     return modifiable;
 }
 
+bool Domain::isModifiable(const Atom& a, const SpanInterval& where) const {
+    if (!dontModifyObsPreds_) return true;
+    boost::unordered_map<Atom, FixedRegion>::const_iterator it = core_->fixedRegions.find(a);
+    if (it == core_->fixedRegions.end()) return true;
+    const FixedRegion& region = it->second;
+
+    // only spans starting no later than where does can overlap it; walk back
+    // from there until no earlier span can reach where's start range
+    SpanInterval key(where.start().finish(), where.start().finish(), 0, 0);
+    std::vector<SpanInterval>::size_type i =
+            std::upper_bound(region.spans.begin(), region.spans.end(), key, StartFromLess()) - region.spans.begin();
+    while (i > 0) {
+        i--;
+        if (region.maxStartTo[i] < where.start().start()) break;
+        if (intersection(region.spans[i], where)) return false;
+    }
+    return true;
+}
+
+void Domain::rebuildFixedRegion(const Atom& a) {
+    Core& core = mutableCore();
+    Proposition trueAt(a, true);
+    Proposition falseAt(a, false);
+    bool hasTrue = core.partialModel.count(trueAt) != 0;
+    bool hasFalse = core.partialModel.count(falseAt) != 0;
+    if (!hasTrue && !hasFalse) {
+        core.fixedRegions.erase(a);
+        return;
+    }
+
+    FixedRegion region;
+    if (hasTrue) {
+        const SISet& fixed = core.partialModel.at(trueAt);
+        region.spans.insert(region.spans.end(), fixed.begin(), fixed.end());
+    }
+    if (hasFalse) {
+        const SISet& fixed = core.partialModel.at(falseAt);
+        region.spans.insert(region.spans.end(), fixed.begin(), fixed.end());
+    }
+    std::sort(region.spans.begin(), region.spans.end(), StartFromLess());
+    unsigned int maxSoFar = 0;
+    for (std::vector<SpanInterval>::const_iterator it = region.spans.begin(); it != region.spans.end(); it++) {
+        maxSoFar = (std::max)(maxSoFar, it->start().finish());
+        region.maxStartTo.push_back(maxSoFar);
+    }
+    core.fixedRegions[a] = region;
+}
+
+void Domain::rebuildFixedRegions() {
+    Core& core = mutableCore();
+    core.fixedRegions.clear();
+    for (PropMap::const_iterator it = core.partialModel.begin(); it != core.partialModel.end(); it++) {
+        if (core.fixedRegions.count(it->first.atom()) == 0) rebuildFixedRegion(it->first.atom());
+    }
+}
+
 void Domain::addFact(const ELSentence& e) {
     if (!e.hasInfWeight()) throw std::invalid_argument("Cannot enforce facts that have finite weight");
     if (e.sentence()->getTypeCode() == Atom::TypeCode) {
@@ -65,18 +302,20 @@ void Domain::addFact(const ELSentence& e) {
 
 void Domain::addFact(const Proposition& p, const SISet& where) {
     // resize where
+    Core& core = mutableCore();
     SISet newSet(where);
-    if (!maxInterval_.isNull()) newSet.setMaxInterval(span(where.maxInterval(), maxInterval_));
+    if (!core.maxInterval.isNull()) newSet.setMaxInterval(span(where.maxInterval(), core.maxInterval));
 
-    if (partialModel_.count(p) == 0) {
-        partialModel_.insert(std::make_pair(p, newSet));
+    if (core.partialModel.count(p) == 0) {
+        core.partialModel.insert(std::make_pair(p, newSet));
     } else {
-        partialModel_.at(p).setMaxInterval(newSet.maxInterval());
-        partialModel_.at(p).add(newSet);
+        core.partialModel.at(p).setMaxInterval(newSet.maxInterval());
+        core.partialModel.at(p).add(newSet);
     }
-   // predTypes_.insert(p.atom().predicateType());
-    allAtoms_.insert(p.atom());
+   // core.predTypes.insert(p.atom().predicateType());
+    insertAtom(p.atom());
     growMaxInterval(where.maxInterval());
+    rebuildFixedRegion(p.atom());
 }
 /*
 void Domain::unsetAtomAt(const std::string& name, const SISet& where) {
@@ -92,15 +331,27 @@ void Domain::unsetAtomAt(const std::string& name, const SISet& where) {
 */
 
 void Domain::addFormula(const ELSentence& e) {
-    //ELSentence toAdd = e;
-    formulas_.push_back(e);
+    ELSentence toAdd = e;
+    SentenceSimplifier simplifier;
+    boost::shared_ptr<Sentence> simplified = simplifier.simplify(toAdd.sentence());
+    eliminatedNodes_ += simplifier.eliminated();
+    if (simplified->getTypeCode() == BoolLit::TypeCode && static_cast<const BoolLit&>(*simplified).value()) {
+        // the formula is gone, but its quantification still widens the domain
+        eliminatedNodes_++;
+        if (e.isQuantified()) growMaxInterval(e.quantification().maxInterval());
+        return;
+    }
+
+    // share structurally equal subformulas with the formulas already here
+    toAdd.setSentence(core_->interner->intern(simplified));
+    formulas_.push_back(toAdd);
 
     if (e.isQuantified()) {
         SISet set = e.quantification();
         Interval toAddMaxInt = set.maxInterval();
         growMaxInterval(toAddMaxInt);
-        //if (toAddMaxInt != maxInterval_) {
-         //   set.setMaxInterval(maxInterval_);
+        //if (toAddMaxInt != maxInterval()) {
+         //   set.setMaxInterval(maxInterval());
         //    toAdd.setQuantification(set);
        // }
     }
@@ -109,9 +360,11 @@ void Domain::addFormula(const ELSentence& e) {
     e.sentence()->visit(pcollect);
     predTypes_.insert(pcollect.types.begin(), pcollect.types.end());
     */
-    AtomCollector acollect;
-    e.sentence()->visit(acollect);
-    allAtoms_.insert(acollect.atoms.begin(), acollect.atoms.end());
+    // collects the formula's atoms; only detaches the shared core if the
+    // formula actually brings new ones
+    indexFormula(formulas_.size()-1);
+    programs_.push_back(SentenceProgram(toAdd.sentence()));
+    groupFormula(formulas_.size()-1);
     // update our list of unobs preds
     /*
     PredCollector collect;
@@ -124,19 +377,21 @@ void Domain::addFormula(const ELSentence& e) {
 
 void Domain::addAtom(const Atom& a) {
  //   predTypes_.insert(a.predicateType());
-    allAtoms_.insert(a);
+    insertAtom(a);
 }
 
 Model Domain::randomModel(boost::mt19937& rng) const {
-    Model newModel(maxInterval_);
+    const Interval& maxInterval = core_->maxInterval;
+    const PropMap& partialModel = core_->partialModel;
+    Model newModel(maxInterval);
     //std::set<Atom, atomcmp> atoms = observations_.atoms();
-    for (boost::unordered_set<Atom>::const_iterator it = allAtoms_.begin(); it != allAtoms_.end(); it++) {
-        SISet random = SISet::randomSISet(isLiquid(it->name()), maxInterval_, rng);
+    for (boost::unordered_set<Atom>::const_iterator it = core_->allAtoms.begin(); it != core_->allAtoms.end(); it++) {
+        SISet random = SISet::randomSISet(isLiquid(it->name()), maxInterval, rng);
         // enforce our partial model
         Proposition trueProp(*it, true);
         Proposition falseProp(*it, false);
-        if (partialModel_.count(trueProp) != 0) random.add(     partialModel_.at(trueProp));
-        if (partialModel_.count(falseProp) != 0) random.subtract(partialModel_.at(falseProp));
+        if (partialModel.count(trueProp) != 0) random.add(     partialModel.at(trueProp));
+        if (partialModel.count(falseProp) != 0) random.subtract(partialModel.at(falseProp));
 
         random.makeDisjoint();
         //newModel.clearAtom(obsPair->first);
@@ -147,7 +402,8 @@ Model Domain::randomModel(boost::mt19937& rng) const {
 
 
 void Domain::setMaxInterval(const Interval& maxInterval) {
-    maxInterval_ = maxInterval;
+    Core& core = mutableCore();
+    core.maxInterval = maxInterval;
     // resize formulas
     for (std::vector<ELSentence>::iterator it = formulas_.begin(); it != formulas_.end(); it++) {
         if (it->isQuantified()) {
@@ -156,9 +412,10 @@ void Domain::setMaxInterval(const Interval& maxInterval) {
             it->setQuantification(copy);
         }
     }
-    for (PropMap::iterator it = partialModel_.begin(); it != partialModel_.end(); it++) {
-        partialModel_.at(it->first).setMaxInterval(maxInterval);
+    for (PropMap::iterator it = core.partialModel.begin(); it != core.partialModel.end(); it++) {
+        it->second.setMaxInterval(maxInterval);
     }
+    rebuildFixedRegions();
 }
 
 bool Domain::isLiquid(const std::string& predicate) const {
@@ -172,25 +429,120 @@ double Domain::score(const ELSentence& w, const Model& m) const {
 
     SISet sat = w.sentence()->dSatisfied(m, *this, quantification);
 
-    return (double)sat.size() * w.weight();
+    return (double)sat.disjointSize() * w.weight();
 }
 
 double Domain::score(const Model& m) const {
+    SentenceProgram::Registers regs;
+    std::vector<double> scores(formulas_.size(), 0.0);
+    // scratch space for the batches
+    std::vector<SISet> quantifications;
+    std::vector<const SentenceProgram*> batch;
+    std::vector<const SISet*> wheres;
+    std::vector<std::size_t> ids;
+    std::vector<SentenceProgram::Registers> batchRegs;
+    std::vector<SentenceProgram::Count> counts;
+    for (std::size_t g = 0; g < templates_.size(); g++) {
+        const std::vector<std::size_t>& group = templates_[g];
+        ids.clear();
+        for (std::size_t j = 0; j < group.size(); j++) {
+            std::size_t i = group[j];
+            // restricted evaluation beats batching for these
+            if (formulas_[i].isQuantified() && programs_[i].hasDelta()) scores[i] = score(i, m, regs);
+            else ids.push_back(i);
+        }
+        if (ids.size() == 1) scores[ids[0]] = score(ids[0], m, regs);
+        if (ids.size() <= 1) continue;
+
+        quantifications.assign(ids.size(), SISet(false, maxInterval()));
+        batch.resize(ids.size());
+        wheres.resize(ids.size());
+        for (std::size_t j = 0; j < ids.size(); j++) {
+            const ELSentence& w = formulas_[ids[j]];
+            batch[j] = &programs_[ids[j]];
+            wheres[j] = NULL;
+            if (w.isQuantified()) {
+                quantifications[j] = w.quantification();
+                wheres[j] = &quantifications[j];
+            }
+        }
+        SentenceProgram::countBatch(batch, m, *this, wheres, batchRegs, counts);
+        for (std::size_t j = 0; j < ids.size(); j++) {
+            scores[ids[j]] = (double)counts[j].satisfied * formulas_[ids[j]].weight();
+        }
+    }
+
+    // added up in formula order, as by score(m, pool)
     double sum = 0.0;
-    for (std::vector<ELSentence>::const_iterator it = formulas_.begin(); it != formulas_.end(); it++) {
-        double x = score(*it, m);
-        sum += x;
+    for (std::size_t i = 0; i < scores.size(); i++) {
+        sum += scores[i];
+    }
+    return sum;
+}
+
+double Domain::score(const Model& m, ThreadPool& pool) const {
+    std::vector<SentenceProgram::Registers> regs(pool.size());
+    std::vector<double> scores(formulas_.size(), 0.0);
+    ScoreFormula task = {this, &m, &regs, &scores};
+    pool.run(formulas_.size(), task);
+
+    double sum = 0.0;
+    for (std::size_t i = 0; i < scores.size(); i++) {
+        sum += scores[i];
     }
     return sum;
 }
 
+double Domain::score(std::size_t formulaId, const Model& m, SentenceProgram::Registers& regs) const {
+    const ELSentence& w = formulas_.at(formulaId);
+    SISet quantification(false, maxInterval());
+    if (w.isQuantified()) quantification = w.quantification();
+
+    SentenceProgram::Count count = programs_[formulaId].count(m, *this,
+            (w.isQuantified() ? &quantification : NULL), regs);
+    return (double)count.satisfied * w.weight();
+}
+
 bool Domain::isFullySatisfied(const Model& m) const {
-    for (formula_const_iterator it = formulas_begin(); it != formulas_end(); it++) {
-        if (!it->fullySatisfied(m, *this)) return false;
+    SentenceProgram::Registers regs;
+    for (std::size_t i = 0; i < formulas_.size(); i++) {
+        if (!isFullySatisfied(i, m, regs)) return false;
     }
     return true;
 }
 
+SISet Domain::dSatisfied(std::size_t formulaId, const Model& m, SentenceProgram::Registers& regs) const {
+    const ELSentence& w = formulas_.at(formulaId);
+    if (!w.isQuantified()) return programs_[formulaId].dSatisfied(m, *this, regs);
+    return programs_[formulaId].dSatisfied(m, *this, w.quantification(), regs);
+}
+
+SISet Domain::dNotSatisfied(std::size_t formulaId, const Model& m, SentenceProgram::Registers& regs) const {
+    const ELSentence& w = formulas_.at(formulaId);
+    if (!w.isQuantified()) {
+        SISet set = programs_[formulaId].satisfied(m, *this, regs);
+        set = set.compliment();
+        set.makeDisjoint();
+        return set;
+    }
+    // take out what's satisfied rather than intersecting with the compliment
+    SISet sat = programs_[formulaId].dSatisfied(m, *this, w.quantification(), regs);
+    SISet set = w.quantification();
+    set.setForceLiquid(false);
+    for (SISet::const_iterator it = sat.begin(); it != sat.end() && set.begin() != set.end(); it++) {
+        set.subtract(*it);
+    }
+    set.makeDisjoint();
+    return set;
+}
+
+bool Domain::isFullySatisfied(std::size_t formulaId, const Model& m, SentenceProgram::Registers& regs) const {
+    const ELSentence& w = formulas_.at(formulaId);
+    SISet quantification(false, maxInterval());
+    if (w.isQuantified()) quantification = w.quantification();
+    return programs_[formulaId].fullySatisfied(m, *this, (w.isQuantified() ? &quantification : NULL), regs);
+}
+
 Domain Domain::replaceInfForms() const {
     Domain d = *this;
 
@@ -215,41 +567,97 @@ Domain Domain::replaceInfForms() const {
     return d;
 }
 
+Domain Domain::pruneFormulas() const {
+    Domain d = *this;
+    if (!dontModifyObsPreds_ || core_->partialModel.empty()) return d;
+
+    const PropMap& partialModel = core_->partialModel;
+    std::vector<ELSentence> kept;
+    std::size_t narrowed = 0;
+    for (std::vector<ELSentence>::const_iterator it = formulas_.begin(); it != formulas_.end(); it++) {
+        ELSentence f = *it;
+        boost::unordered_set<Atom> positive, negative;
+        boost::shared_ptr<Sentence> polar = polarized(f.sentence(), false, positive, negative);
+        if (!polar) {
+            kept.push_back(f);
+            continue;
+        }
+        // every node but negation is monotone, so a formula is true in any
+        // model at least where it's true with its positive atoms lowest and
+        // its negated ones highest, and at most where it's true the other
+        // way round
+        Model mustModel(maxInterval()), mayModel(maxInterval());
+        for (boost::unordered_set<Atom>::const_iterator aIt = positive.begin(); aIt != positive.end(); aIt++) {
+            mustModel.setAtom(*aIt, boundOf(*aIt, false, partialModel, maxSpanInterval()));
+            mayModel.setAtom(*aIt, boundOf(*aIt, true, partialModel, maxSpanInterval()));
+        }
+        for (boost::unordered_set<Atom>::const_iterator aIt = negative.begin(); aIt != negative.end(); aIt++) {
+            mustModel.setAtom(negatedCopy(*aIt), boundOf(*aIt, true, partialModel, maxSpanInterval()));
+            mayModel.setAtom(negatedCopy(*aIt), boundOf(*aIt, false, partialModel, maxSpanInterval()));
+        }
+        SISet must = polar->dSatisfied(mustModel, *this);
+        SISet may = polar->dSatisfied(mayModel, *this);
+        must.setForceLiquid(false);
+        may.setForceLiquid(false);
+
+        // only the intervals in between depend on the free atoms
+        SISet quantification(maxSpanInterval(), false, maxInterval());
+        if (f.isQuantified()) quantification = f.quantification();
+        SISet free = intersection(quantification, may);
+        free.subtract(must);
+        if (free.empty()) continue;
+        // a region in many pieces costs more to evaluate on than it saves
+        if (std::distance(free.begin(), free.end()) <= maxPrunedSpans && free.size() != quantification.size()) {
+            f.setQuantification(free);
+            narrowed++;
+        }
+        kept.push_back(f);
+    }
+
+    LOG(LOG_INFO) << "pruning formulas against the facts dropped " << formulas_.size() - kept.size()
+            << " formulas and narrowed " << narrowed;
+    d.formulas_.swap(kept);
+    d.rebuildAtomIndex();
+    d.compileFormulas();
+    return d;
+}
+
 void Domain::growMaxInterval(const Interval& maxInterval) {
-    if (maxInterval_.isNull()) setMaxInterval(maxInterval);
-    if (maxInterval.start() < maxInterval_.start()
-            || maxInterval.finish() > maxInterval_.finish()) {
-        setMaxInterval(span(maxInterval, maxInterval_));
+    if (core_->maxInterval.isNull()) setMaxInterval(maxInterval);
+    if (maxInterval.start() < core_->maxInterval.start()
+            || maxInterval.finish() > core_->maxInterval.finish()) {
+        setMaxInterval(span(maxInterval, core_->maxInterval));
     }
 }
 
 void Domain::printDebugDescription(std::ostream& out) const {
     out << "Domain at memory location: " << (void *)this << "\n";
     out << "  dontModifyObsPreds: " << dontModifyObsPreds_ << "\n";
-    out << "  MaxInterval: " << maxInterval_ << "\n";
+    out << "  MaxInterval: " << core_->maxInterval << "\n";
     out << "  Formulas:\n";
     for (std::vector<ELSentence>::const_iterator it = formulas_.begin(); it != formulas_.end(); it++) {
         out << "    " << *it << "\n";
     }
     out << "  Facts:\n";
-    for (PropMap::const_iterator it = partialModel_.begin(); it != partialModel_.end(); it++) {
+    for (PropMap::const_iterator it = core_->partialModel.begin(); it != core_->partialModel.end(); it++) {
         std::pair<Proposition, SISet> pair = *it;
         out << "    " << pair.first << " @ " << pair.second << "\n";
     }
     // ignore atoms and generator for now
     out << "  allAtoms: ";
-    std::copy(allAtoms_.begin(),  allAtoms_.end(), std::ostream_iterator<Atom>(out, ", "));
+    std::copy(core_->allAtoms.begin(),  core_->allAtoms.end(), std::ostream_iterator<Atom>(out, ", "));
     out << std::endl;
 }
 
 bool operator==(const Domain& l, const Domain& r) {
     return (
             l.dontModifyObsPreds_ == r.dontModifyObsPreds_ &&
-            l.maxInterval_ == r.maxInterval_ &&
+            (l.core_ == r.core_ ||
+                    (l.core_->maxInterval == r.core_->maxInterval &&
+                    l.core_->partialModel == r.core_->partialModel &&
+                    //l.core_->predTypes == r.core_->predTypes &&
+                    l.core_->allAtoms == r.core_->allAtoms)) &&
             l.formulas_ == r.formulas_ &&
-            l.partialModel_ == r.partialModel_ &&
-            //l.predTypes_ == r.predTypes_ &&
-            l.allAtoms_ == r.allAtoms_ &&
             l.generator_ == r.generator_
     );
 }
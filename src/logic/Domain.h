@@ -17,6 +17,7 @@
 #include <limits>
 #include <stdexcept>
 #include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/unordered_set.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/serialization/access.hpp>
@@ -31,8 +32,20 @@
 #include "../LRUCache.h"
 #include "../util/Utils.h"
 
+class ThreadPool;
+
 std::string modelToString(const Model& m);
 
+/**
+ * A PEL domain: facts, atoms, a max interval and a set of weighted formulas.
+ *
+ * The facts, atoms, max interval and the indices derived from them live in
+ * a core that copies of a domain share; the core is only duplicated when a
+ * copy modifies it.  The table the formulas' subformulas are interned in is
+ * shared by every copy, even after its core is duplicated.  Copying a domain and then replacing or reweighting its
+ * formulas (as replaceInfForms() and MCSat do) therefore only costs the
+ * formulas themselves.
+ */
 class Domain {
 public:
     typedef boost::unordered_map<Proposition, SISet> PropMap;
@@ -40,6 +53,7 @@ public:
     typedef std::vector<ELSentence>::const_iterator     formula_const_iterator;
     typedef PropMap::const_iterator                     fact_const_iterator;
     typedef boost::unordered_set<Atom>::const_iterator  atom_const_iterator;
+    typedef std::size_t                                 atom_id;
 
     Domain();
     Domain(const Domain& d);
@@ -58,9 +72,79 @@ public:
     std::size_t atoms_size() const;
     std::size_t formulas_size() const;
 
+    /**
+     * Get the id of an atom in this domain.  Ids are dense (0 to
+     * atoms_size()-1), assigned as atoms are added and never change
+     * afterwards.
+     *
+     * @param a  the atom to look up
+     * @return the atom's id, or nothing if a isn't in this domain
+     */
+    boost::optional<atom_id> atomId(const Atom& a) const;
+
+    /**
+     * Get the atom with the given id.
+     *
+     * @param id  an atom id (less than atoms_size())
+     * @return the atom with that id
+     */
+    const Atom& atomById(atom_id id) const;
+
+    /**
+     * Get the ids of the formulas (positions in formulas_begin()..
+     * formulas_end()) that mention a given atom.  Maintained as formulas
+     * are added, so this is a lookup.
+     *
+     * @param atomId  the id of the atom
+     * @return sorted ids of the formulas that contain the atom
+     */
+    const std::vector<std::size_t>& formulasWithAtom(atom_id atomId) const;
+
+    /**
+     * Get the ids of the distinct atoms appearing in a formula.
+     *
+     * @param formulaId  the position of the formula in this domain
+     * @return ids of the atoms in that formula
+     */
+    const std::vector<std::size_t>& atomsInFormula(std::size_t formulaId) const;
+
+    /**
+     * Get the compiled evaluation program of a formula's sentence.  Programs
+     * are compiled once, when the formula is added.
+     *
+     * @param formulaId  the position of the formula in this domain
+     * @return the formula's program
+     */
+    const SentenceProgram& formulaProgram(std::size_t formulaId) const;
+
+    /**
+     * Get the formulas grouped by template: formulas whose programs have the
+     * same shape (see SentenceProgram::sameShape()), such as the instances
+     * of one formula over different constants, end up in the same group.
+     * score() evaluates each group in one batch.
+     *
+     * @return groups of formula ids, each in increasing order
+     */
+    const std::vector<std::vector<std::size_t> >& formulaTemplates() const;
+
     void clearFormulas();
     void clearFacts();
+
+    /**
+     * Add a formula.  Its sentence is simplified first (see
+     * SentenceSimplifier); a formula that simplifies to true adds the same
+     * to the score of every model, so it isn't added at all.
+     *
+     * @param e  the formula to add
+     */
     void addFormula(const ELSentence& e);
+
+    /**
+     * Get the number of sentence nodes removed by simplifying the formulas
+     * added so far, including all the nodes of formulas dropped as
+     * tautologies.
+     */
+    std::size_t eliminatedNodes() const;
     template <class InputIterator>
     void addFormulas(InputIterator begin, InputIterator end);
     void addFact(const ELSentence& e);
@@ -77,6 +161,19 @@ public:
     SISet getModifiableSISet(const Atom& a) const;
     SISet getModifiableSISet(const Atom& a, const SISet& where) const;
 
+    /**
+     * Check whether atom a may be changed everywhere in the given span
+     * interval (i.e. no fact fixes its value anywhere in where).  Uses the
+     * per-atom fixed regions precomputed when facts are added, so no set
+     * subtraction is performed.
+     *
+     * @param a      the atom to change
+     * @param where  the span interval the change covers
+     * @return true if the change doesn't touch an observed region of a (or
+     *   if observed predicates are allowed to be modified)
+     */
+    bool isModifiable(const Atom& a, const SpanInterval& where) const;
+
     /**
      * Get a copy of this domain with all infinitely-weighted formulas
      * expressed as high weights (i.e. make hard constraints pseudo-hard).
@@ -86,6 +183,22 @@ public:
      */
     Domain replaceInfForms() const;
 
+    /**
+     * Get a copy of this domain with its formulas restricted to where their
+     * truth still depends on atoms the facts leave free.  Each formula's
+     * quantification is narrowed to the intervals where it can be either
+     * true or false in a model agreeing with the facts, and formulas with
+     * no such intervals are dropped.  This only changes the score of every
+     * model by the same amount, so it doesn't change which model is best.
+     * Quantifications that would be split into more than maxPrunedSpans
+     * span intervals are left as they are.
+     *
+     * Nothing is pruned if observed predicates may be modified.
+     *
+     * @return a copy of the domain with its formulas pruned
+     */
+    Domain pruneFormulas() const;
+
     NameGenerator& nameGenerator();
     Model defaultModel() const;
     Model randomModel(boost::mt19937& rng) const;
@@ -100,14 +213,63 @@ public:
     double score(const ELSentence& s, const Model& m) const;
     double score(const Model& m) const;
 
+    /**
+     * Score a formula of this domain using its compiled program.
+     *
+     * @param formulaId  the position of the formula in this domain
+     * @param m     the model to score
+     * @param regs  scratch registers for the program, reused across calls
+     * @return the same as score(formula, m)
+     */
+    double score(std::size_t formulaId, const Model& m, SentenceProgram::Registers& regs) const;
+
+    /**
+     * Score a model, scoring the formulas in parallel on a thread pool.  The
+     * formula scores are added up in formula order, so the result is the
+     * same as score(m) whatever the size of the pool.
+     *
+     * @param m     the model to score
+     * @param pool  the threads to score the formulas on
+     * @return the same as score(m)
+     */
+    double score(const Model& m, ThreadPool& pool) const;
+
     bool isFullySatisfied(const Model& m) const;
 
+    /**
+     * Get where a formula of this domain is true (or false), using its
+     * compiled program.  A quantified formula is only evaluated on its
+     * quantification when the program allows it (see
+     * SentenceProgram::hasDelta()).
+     *
+     * @param formulaId  the position of the formula in this domain
+     * @param m     the model to evaluate on
+     * @param regs  scratch registers for the program, reused across calls
+     * @return the same as the formula's ELSentence::dSatisfied(m, *this)
+     *   (or dNotSatisfied())
+     */
+    SISet dSatisfied(std::size_t formulaId, const Model& m, SentenceProgram::Registers& regs) const;
+    SISet dNotSatisfied(std::size_t formulaId, const Model& m, SentenceProgram::Registers& regs) const;
+
+    /**
+     * Check whether a formula of this domain is true everywhere it is
+     * quantified, using its compiled program.
+     *
+     * @param formulaId  the position of the formula in this domain
+     * @param m     the model to check
+     * @param regs  scratch registers for the program, reused across calls
+     * @return the same as the formula's ELSentence::fullySatisfied(m, *this)
+     */
+    bool isFullySatisfied(std::size_t formulaId, const Model& m, SentenceProgram::Registers& regs) const;
+
     void printDebugDescription(std::ostream& out) const;
 
     friend bool operator==(const Domain& l, const Domain& r);
     friend bool operator!=(const Domain& l, const Domain& r);
 
     static const unsigned int hardFormulaFactor = 10;
+    // the most span intervals pruneFormulas() narrows a quantification to
+    static const long maxPrunedSpans = 64;
 private:
     friend class boost::serialization::access;
     template <class Archive>
@@ -115,12 +277,53 @@ private:
 
     void growMaxInterval(const Interval& maxInterval);
 
+    // the span intervals where an atom's truth value is fixed by facts
+    struct FixedRegion {
+        std::vector<SpanInterval> spans;        // sorted by start().start()
+        std::vector<unsigned int> maxStartTo;   // prefix max of start().finish()
+    };
+
+    // everything but the formulas; shared between copies (copy on write)
+    struct Core {
+        Interval maxInterval;
+        PropMap partialModel;
+        //boost::unordered_set<PredicateType> predTypes;
+        boost::unordered_set<Atom> allAtoms;
+        // derived from partialModel/allAtoms; not serialized or compared
+        boost::unordered_map<Atom, FixedRegion> fixedRegions;
+        boost::unordered_map<Atom, atom_id> atomIds;
+        std::vector<Atom> atomsById;
+        // shares equal subformulas between formulas; not serialized.  Held
+        // by pointer so that detached cores still share it: the table only
+        // grows, and its nodes are never modified, so a node one copy of a
+        // domain interned is safe for every other copy to reuse.  Copies
+        // must not add formulas from different threads at once.
+        boost::shared_ptr<SentenceInterner> interner;
+
+        Core();
+    };
+
+    // get the core for modification, detaching it from other copies first
+    Core& mutableCore();
+    // add an atom to the core (if it's new) and return its id
+    atom_id insertAtom(const Atom& a);
+    void indexFormula(std::size_t formulaId);
+    void rebuildAtomIndex();
+    void compileFormulas();
+    // put a newly compiled formula into its template group
+    void groupFormula(std::size_t formulaId);
+    void rebuildFixedRegion(const Atom& a);
+    void rebuildFixedRegions();
+
     bool dontModifyObsPreds_;
-    Interval maxInterval_;
+    boost::shared_ptr<Core> core_;
     std::vector<ELSentence> formulas_;
-    PropMap partialModel_;
-    //boost::unordered_set<PredicateType> predTypes_;
-    boost::unordered_set<Atom> allAtoms_;
+    // occurrence index over formulas_; derived, not serialized or compared
+    std::vector<std::vector<std::size_t> > formulasWithAtom_;  // by atom id
+    std::vector<std::vector<std::size_t> > atomsInFormula_;    // by formula id
+    std::vector<SentenceProgram> programs_;                    // by formula id
+    std::vector<std::vector<std::size_t> > templates_;         // formula ids by shape
+    std::size_t eliminatedNodes_;   // by simplifying formulas; not serialized
 
     NameGenerator generator_;
 
@@ -130,22 +333,35 @@ private:
 void swap(Domain& a, Domain& b);
 
 // IMPLEMENTATION
+inline Domain::Core::Core()
+    : maxInterval(),
+      partialModel(),
+      allAtoms(),
+      fixedRegions(),
+      atomIds(),
+      atomsById(),
+      interner(new SentenceInterner()) {}
+
 inline Domain::Domain()
     : dontModifyObsPreds_(true),
-      maxInterval_(),
+      core_(new Core()),
       formulas_(),
-      partialModel_(),
-    //  predTypes_(),
-      allAtoms_(),
-      generator_(){};
+      formulasWithAtom_(),
+      atomsInFormula_(),
+      programs_(),
+      templates_(),
+      eliminatedNodes_(0),
+      generator_() {};
 
 inline Domain::Domain(const Domain& d)
     : dontModifyObsPreds_(d.dontModifyObsPreds_),
-      maxInterval_(d.maxInterval_),
+      core_(d.core_),
       formulas_(d.formulas_),
-      partialModel_(d.partialModel_),
-    //  predTypes_(d.predTypes_),
-      allAtoms_(d.allAtoms_),
+      formulasWithAtom_(d.formulasWithAtom_),
+      atomsInFormula_(d.atomsInFormula_),
+      programs_(d.programs_),
+      templates_(d.templates_),
+      eliminatedNodes_(d.eliminatedNodes_),
       generator_(d.generator_) {};
 
 inline Domain& Domain::operator=(Domain d) {
@@ -156,19 +372,49 @@ inline Domain& Domain::operator=(Domain d) {
 
 inline Domain::formula_const_iterator Domain::formulas_begin() const {return formulas_.begin();}
 inline Domain::formula_const_iterator Domain::formulas_end() const {return formulas_.end();}
-inline Domain::fact_const_iterator Domain::facts_begin() const {return partialModel_.begin();}
-inline Domain::fact_const_iterator Domain::facts_end() const {return partialModel_.end();}
-inline Domain::atom_const_iterator Domain::atoms_begin() const { return allAtoms_.begin();}
-inline Domain::atom_const_iterator Domain::atoms_end() const { return allAtoms_.end();}
+inline Domain::fact_const_iterator Domain::facts_begin() const {return core_->partialModel.begin();}
+inline Domain::fact_const_iterator Domain::facts_end() const {return core_->partialModel.end();}
+inline Domain::atom_const_iterator Domain::atoms_begin() const { return core_->allAtoms.begin();}
+inline Domain::atom_const_iterator Domain::atoms_end() const { return core_->allAtoms.end();}
+
+inline std::size_t Domain::atoms_size() const { return core_->allAtoms.size();}
+
+inline boost::optional<Domain::atom_id> Domain::atomId(const Atom& a) const {
+    boost::unordered_map<Atom, atom_id>::const_iterator it = core_->atomIds.find(a);
+    if (it == core_->atomIds.end()) return boost::optional<atom_id>();
+    return it->second;
+}
+
+inline const Atom& Domain::atomById(atom_id id) const { return core_->atomsById.at(id);}
 
-inline std::size_t Domain::atoms_size() const { return allAtoms_.size();}
+inline const std::vector<std::size_t>& Domain::atomsInFormula(std::size_t formulaId) const {
+    return atomsInFormula_.at(formulaId);
+}
+
+inline const SentenceProgram& Domain::formulaProgram(std::size_t formulaId) const {
+    return programs_.at(formulaId);
+}
+
+inline const std::vector<std::vector<std::size_t> >& Domain::formulaTemplates() const {
+    return templates_;
+}
+
+inline std::size_t Domain::eliminatedNodes() const { return eliminatedNodes_;}
 
 inline void Domain::clearFormulas() {
     formulas_.clear();
+    formulasWithAtom_.clear();
+    atomsInFormula_.clear();
+    programs_.clear();
+    templates_.clear();
+    eliminatedNodes_ = 0;
 }
 
 inline void Domain::clearFacts() {
-    partialModel_.clear();
+    if (core_->partialModel.empty()) return;
+    Core& core = mutableCore();
+    core.partialModel.clear();
+    core.fixedRegions.clear();
 }
 
 template <class InputIterator>
@@ -189,28 +435,41 @@ void Domain::addAtoms(InputIterator begin, InputIterator end) {
     }
 }
 
-inline bool Domain::hasFact(const Proposition& p) const {return partialModel_.count(p) != 0; }
-inline SISet Domain::lookupFact(const Proposition& p) const { return partialModel_.at(p);}
+inline bool Domain::hasFact(const Proposition& p) const {return core_->partialModel.count(p) != 0; }
+inline SISet Domain::lookupFact(const Proposition& p) const { return core_->partialModel.at(p);}
 
 inline NameGenerator& Domain::nameGenerator() {return generator_;};
-inline Model Domain::defaultModel() const {return Model(partialModel_, maxInterval_);};
+inline Model Domain::defaultModel() const {return Model(core_->partialModel, core_->maxInterval);};
 inline void Domain::setDontModifyObsPreds(bool b) { dontModifyObsPreds_ = b; }
 inline bool Domain::dontModifyObsPreds() const { return dontModifyObsPreds_; }
-inline Interval Domain::maxInterval() const {return maxInterval_;};
+inline Interval Domain::maxInterval() const {return core_->maxInterval;};
 inline SpanInterval Domain::maxSpanInterval() const {
-    return SpanInterval(maxInterval_.start(), maxInterval_.finish(),
-            maxInterval_.start(), maxInterval_.finish());
+    const Interval& maxInterval = core_->maxInterval;
+    return SpanInterval(maxInterval.start(), maxInterval.finish(),
+            maxInterval.start(), maxInterval.finish());
 };
 
+inline Domain::Core& Domain::mutableCore() {
+    if (!core_.unique()) core_.reset(new Core(*core_));
+    return *core_;
+}
+
 template <class Archive>
 void Domain::serialize(Archive& ar, const unsigned int version) {
+    // never load into a core that other domains share
+    if (Archive::is_loading::value) core_.reset(new Core());
     ar & dontModifyObsPreds_;
-    ar & maxInterval_;
+    ar & core_->maxInterval;
     ar & formulas_;
-    ar & partialModel_;
-   // ar & predTypes_;
-    ar & allAtoms_;
+    ar & core_->partialModel;
+   // ar & core_->predTypes;
+    ar & core_->allAtoms;
     ar & generator_;
+    if (Archive::is_loading::value) {
+        rebuildFixedRegions();
+        rebuildAtomIndex();
+        compileFormulas();
+    }
 }
 
 inline bool operator!=(const Domain& l, const Domain& r) {return !operator==(l, r);}
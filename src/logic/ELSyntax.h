@@ -16,6 +16,7 @@
 /* include all the elements needed for FOL sentences */
 #include "syntax/Atom.h"
 #include "syntax/BoolLit.h"
+#include "syntax/Cardinality.h"
 #include "syntax/Conjunction.h"
 #include "syntax/Constant.h"
 #include "syntax/DiamondOp.h"
@@ -28,6 +29,10 @@
 #include "syntax/Variable.h"
 #include "syntax/ELSentence.h"
 #include "syntax/SentenceVisitor.h"
+#include "syntax/SentenceProgram.h"
+#include "syntax/SentenceInterner.h"
+#include "syntax/SentenceSimplifier.h"
+#include "syntax/SentenceGrounder.h"
 #include "syntax/Proposition.h"
 #include "../SpanInterval.h"
 
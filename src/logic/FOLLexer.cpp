@@ -56,7 +56,7 @@ std::vector<FOLToken> FOLParse::tokenize(std::istream& input) {
                 token.setType(FOLParse::Exactly1);
             } else if (ident == "at1") {
                 // AT1
-                token.setType(FOLParse::AtLeast1);
+                token.setType(FOLParse::AtMost1);
             } else if (ident == "true") {
                 // TRUE
                 token.setType(FOLParse::True);
@@ -39,9 +39,10 @@ struct find_max_interval : public std::unary_function<SpanInterval, void> {
 
 template <class ForwardIterator>
 struct iters {
-    iters(ForwardIterator c, ForwardIterator l) : cur(c), last(l) {};
+    iters(ForwardIterator c, ForwardIterator l) : cur(c), last(l), nextVariableId(1) {};
     ForwardIterator cur;
     ForwardIterator last;
+    std::size_t nextVariableId; // the id to give the next ?type:* variable
 };
 
 class ParseOptions {
@@ -283,6 +284,7 @@ ELSentence doParseWeightedFormula(iters<ForwardIterator> &its) {
         hasWeight = false;
         weight = 0.0;
     }
+    its.nextVariableId = firstFreeVariableId(its);
     boost::shared_ptr<Sentence> p = doParseFormula(its);
     ELSentence sentence(p);
     if (hasWeight) {
@@ -338,103 +340,55 @@ void doParseFormulas(std::vector<ELSentence>& store, std::map<std::string, std::
         } else if (peekTokenType(FOLParse::Type, its)) {
             doParseType(objTypes, predTypes, its);
         } else {
-            std::vector<std::vector<FOLToken> > tokenslist = parse_variable_tokens(objTypes, its);
-            for (std::vector<std::vector<FOLToken> >::iterator it1 = tokenslist.begin(); it1 != tokenslist.end(); ++it1){
-                iters<std::vector<FOLToken>::iterator> it2(it1->begin(), it1->end());                
-                ELSentence formula = doParseWeightedFormula(it2);
-                store.push_back(formula);
+            // parse the formula once and substitute constants for its typed
+            // variables, rather than parsing it again for every grounding
+            ELSentence formula = doParseWeightedFormula(its);
+            SentenceGrounder grounder(formula, objTypes);
+            ELSentence ground;
+            while (grounder.next(ground)) {
+                store.push_back(ground);
             }
         }
     }
 }
-    
+
 template <class ForwardIterator>
-std::vector<std::vector<FOLToken> > parse_variable_tokens(std::map<std::string, std::set<std::string> >& objTypes, iters<ForwardIterator> &its) {
-    std::vector<std::vector<FOLToken> > tokenslist;
-    std::map<Variable, std::vector<std::string> > predTypes;
-    
-    while (!endOfTokens(its)){
-        if (peekTokenType(FOLParse::EndLine, its)){
-            consumeTokenType(FOLParse::EndLine, its);
-            break;
-        } else {
-            if (tokenslist.size() == 0) {
-                std::vector<FOLToken> tokens;
-                tokenslist.push_back(tokens);
-            }
-            if (peekTokenType(FOLParse::Variable, its)){
-                std::string var_name = consumeVariable(its);
-                std::set<std::string> var_values = objTypes.find(var_name)->second;
-                
-                consumeTokenType(FOLParse::Colon, its);
-                if (peekTokenType(FOLParse::Star, its)) {
-                    consumeTokenType(FOLParse::Star, its);
-                    std::vector<std::vector<FOLToken> > tokenslist_copy;
-                    for (std::vector<std::vector<FOLToken> >::iterator it1 = tokenslist.begin(); it1 != tokenslist.end(); ++it1){
-                        for (std::set<std::string>::iterator it2 = var_values.begin(); it2 != var_values.end(); ++it2) {
-                            FOLToken token;
-                            std::vector<FOLToken> tokens_copy(*it1);
-                            std::string ident = *it2;
-                            token.setType(FOLParse::Identifier);
-                            token.setContents(ident);
-                            tokens_copy.push_back(token);
-                            tokenslist_copy.push_back(tokens_copy);
-                        }                        
-                    }                    
-                    tokenslist = tokenslist_copy;
-                } else {
-                    unsigned int num = consumeNumber(its);
-                    Variable var_token(var_name, num);
-                    if (predTypes.find(var_token) != predTypes.end()) {
-                        std::vector<std::string> idents = predTypes.find(var_token)->second;   
-                        std::vector<std::vector<FOLToken> >::iterator it1 = tokenslist.begin();
-                        std::vector<std::string>::iterator  it3 = idents.begin(); 
-                        for (;
-                        it1 != tokenslist.end() || it3 != idents.end() ; 
-                        ++it1, ++it3) {
-                            FOLToken token;
-                            token.setType(FOLParse::Identifier);
-                            token.setContents(*it3);
-                            it1->push_back(token);
-                        }
-                    } else {
-                        std::vector<std::vector<FOLToken> > tokenslist_copy;
-//                         std::map<Variable, std::vector<std::string> > predTypes_copy;
-                        for (std::map<Variable, std::vector<std::string> >::iterator it4=predTypes.begin(); it4!=predTypes.end(); ++it4){
-                            std::vector<std::string> str_vec;
-                            for (std::vector<std::string>::iterator i5=it4->second.begin(); i5!=it4->second.end(); ++i5){
-                                for (std::size_t i = 0; i < var_values.size(); ++i){
-                                    str_vec.push_back(*i5);
-                                }
-                            }                            
-                            predTypes[it4->first] = str_vec;
-                        }
-                        std::vector<std::string> pred_values;
-                        for (std::vector<std::vector<FOLToken> >::iterator it1 = tokenslist.begin(); it1 != tokenslist.end(); ++it1){
-                            for (std::set<std::string>::iterator it2 = var_values.begin(); it2 != var_values.end(); ++it2) {                                
-                                FOLToken token;
-                                std::vector<FOLToken> tokens_copy(*it1);
-                                std::string ident = *it2;
-                                pred_values.push_back(ident);
-                                token.setType(FOLParse::Identifier);
-                                token.setContents(ident);
-                                tokens_copy.push_back(token);
-                                tokenslist_copy.push_back(tokens_copy);                      
-                            }                        
-                        }
-                        predTypes[var_token] = pred_values;
-                        tokenslist = tokenslist_copy;
-                    }
-                }                
-            } else {
-                for (std::vector<std::vector<FOLToken> >::iterator it1 = tokenslist.begin(); it1 != tokenslist.end(); ++it1){                    
-                        it1->push_back(*(its.cur));
-                }
-                its.cur++;
-            }
-        }        
+std::size_t firstFreeVariableId(const iters<ForwardIterator> &its) {
+    // ?type:* variables are numbered after every ?type:n in the formula
+    std::size_t id = 1;
+    iters<ForwardIterator> scan(its);
+    while (!endOfTokens(scan) && !peekTokenType(FOLParse::EndLine, scan)) {
+        if (!peekTokenType(FOLParse::Variable, scan)) {
+            scan.cur++;
+            continue;
+        }
+        consumeTokenType(FOLParse::Variable, scan);
+        if (!peekTokenType(FOLParse::Colon, scan)) continue;
+        consumeTokenType(FOLParse::Colon, scan);
+        if (peekTokenType(FOLParse::Number, scan)) {
+            id = std::max<std::size_t>(id, consumeNumber(scan) + 1);
+        }
+    }
+    return id;
+}
+
+template <class ForwardIterator>
+std::auto_ptr<Term> doParseVariable(iters<ForwardIterator> &its) {
+    std::string name = consumeVariable(its);
+    if (!peekTokenType(FOLParse::Colon, its)) {
+        return std::auto_ptr<Term>(new Variable(name));
+    }
+    // a typed variable: ?type:n is the same variable wherever it appears,
+    // and every ?type:* is a different one
+    consumeTokenType(FOLParse::Colon, its);
+    std::size_t id;
+    if (peekTokenType(FOLParse::Star, its)) {
+        consumeTokenType(FOLParse::Star, its);
+        id = its.nextVariableId++;
+    } else {
+        id = consumeNumber(its);
     }
-    return tokenslist;
+    return std::auto_ptr<Term>(new Variable(name, id));
 }
 
 /*
@@ -577,8 +531,7 @@ boost::shared_ptr<Atom> doParseAtom(iters<ForwardIterator> &its) {
         std::auto_ptr<Term> c(new Constant(consumeIdent(its)));
         a->push_back(c);
     } else if (peekTokenType(FOLParse::Variable, its)){
-        std::auto_ptr<Term> v(new Variable(consumeVariable(its)));
-        a->push_back(v);
+        a->push_back(doParseVariable(its));
     } else {
         // atom with no args
         consumeTokenType(FOLParse::CloseParen, its);
@@ -590,8 +543,7 @@ boost::shared_ptr<Atom> doParseAtom(iters<ForwardIterator> &its) {
             std::auto_ptr<Term> c(new Constant(consumeIdent(its)));
             a->push_back(c);
         } else {
-            std::auto_ptr<Term> v(new Variable(consumeVariable(its)));
-            a->push_back(v);
+            a->push_back(doParseVariable(its));
         }
     }
     consumeTokenType(FOLParse::CloseParen, its);
@@ -605,10 +557,35 @@ boost::shared_ptr<Sentence> doParseFormula(iters<ForwardIterator> &its) {
 }
 
 template <class ForwardIterator>
-boost::shared_ptr<Sentence> doParseFormula_exat(iters<ForwardIterator> &its) {  // TODO: support exactly 1/at most 1
+boost::shared_ptr<Sentence> doParseFormula_exat(iters<ForwardIterator> &its) {
+    if (peekTokenType(FOLParse::Exactly1, its) || peekTokenType(FOLParse::AtMost1, its)) {
+        return doParseCardinality(its);
+    }
     return doParseFormula_quant(its);
 }
 
+template <class ForwardIterator>
+boost::shared_ptr<Sentence> doParseCardinality(iters<ForwardIterator> &its) {
+    Cardinality::Kind kind = Cardinality::EXACTLY_ONE;
+    if (peekTokenType(FOLParse::AtMost1, its)) {
+        consumeTokenType(FOLParse::AtMost1, its);
+        kind = Cardinality::AT_MOST_ONE;
+    } else {
+        consumeTokenType(FOLParse::Exactly1, its);
+    }
+    std::vector<boost::shared_ptr<Atom> > atoms;
+    consumeTokenType(FOLParse::OpenParen, its);
+    atoms.push_back(doParseAtom(its));
+    while (peekTokenType(FOLParse::Comma, its)) {
+        consumeTokenType(FOLParse::Comma, its);
+        atoms.push_back(doParseAtom(its));
+    }
+    consumeTokenType(FOLParse::CloseParen, its);
+
+    boost::shared_ptr<Sentence> card(new Cardinality(kind, atoms.begin(), atoms.end()));
+    return card;
+}
+
 template <class ForwardIterator>
 boost::shared_ptr<Sentence> doParseFormula_quant(iters<ForwardIterator> &its) { // TODO: support quantification
     return doParseFormula_imp(its);
@@ -803,7 +780,10 @@ boost::shared_ptr<Sentence> doParseStaticFormula(iters<ForwardIterator> &its) {
 }
 
 template <class ForwardIterator>
-boost::shared_ptr<Sentence> doParseStaticFormula_exat(iters<ForwardIterator> &its) {    // TODO: support exactly 1/at most 1
+boost::shared_ptr<Sentence> doParseStaticFormula_exat(iters<ForwardIterator> &its) {
+    if (peekTokenType(FOLParse::Exactly1, its) || peekTokenType(FOLParse::AtMost1, its)) {
+        return doParseCardinality(its);
+    }
     return doParseStaticFormula_quant(its);
 }
 
@@ -939,8 +919,10 @@ void parseFormulaFile(const std::string &filename,
 template <class ForwardIterator>
 void parseFormulas(const ForwardIterator &first,
         const ForwardIterator &last, std::vector<ELSentence>& store) {
-    iters<std::vector<FOLToken>::const_iterator> its(first, last);
-//     doParseFormulas(store, its);
+    iters<ForwardIterator> its(first, last);
+    std::map<std::string, std::set<std::string> > objTypes;
+    std::map<std::string, std::vector<std::string> > predTypes;
+    doParseFormulas(store, objTypes, predTypes, its);
 }
 
 Domain loadDomainFromFiles(const std::string &eventfile, const std::string &formulafile, const ParseOptions& options=ParseOptions()) {
@@ -1034,6 +1016,7 @@ template <class ForwardIterator>
 boost::shared_ptr<Sentence> parseFormula(const ForwardIterator &first,
         const ForwardIterator &last) {
     iters<ForwardIterator> its(first, last);
+    its.nextVariableId = firstFreeVariableId(its);
     return doParseFormula(its);
 }
 
@@ -1041,6 +1024,7 @@ template <class ForwardIterator>
 boost::shared_ptr<Sentence> parseStaticFormula(const ForwardIterator &first,
         const ForwardIterator &last) {
     iters<ForwardIterator> its(first, last);
+    its.nextVariableId = firstFreeVariableId(its);
     return doParseStaticFormula(its);
 }
 
@@ -53,8 +53,8 @@ namespace FOLParse {
         case FOLParse::Exactly1:
             out << "Exactly1 (ex1)";
             break;
-        case FOLParse::AtLeast1:
-            out << "AtLeast1 (at1)";
+        case FOLParse::AtMost1:
+            out << "AtMost1 (at1)";
             break;
         case FOLParse::EndLine:
             out << "End line (\\n)";
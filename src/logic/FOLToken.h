@@ -27,7 +27,7 @@ enum TokenType { Invalid,
     Not,
     Diamond,
     Exactly1,
-    AtLeast1,
+    AtMost1,
     EndLine,
     OpenBracket,
     CloseBracket,
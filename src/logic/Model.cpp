@@ -9,9 +9,15 @@
 #include <sstream>
 #include "Model.h"
 #include "ELSyntax.h"
+#include <boost/detail/atomic_count.hpp>
+
+namespace {
+    // shared by all models, so versions from different models never clash
+    boost::detail::atomic_count versionCounter(0);
+}
 
 Model::Model(const std::vector<FOL::Event>& pairs, const Interval& maxInterval)
-    : amap_(), maxInterval_(maxInterval) {
+    : amap_(), versions_(), maxInterval_(maxInterval), fingerprint_(0) {
     /*
     unsigned int smallest=UINT_MAX, largest=0;
     // find the max interval
@@ -47,10 +53,12 @@ Model::Model(const std::vector<FOL::Event>& pairs, const Interval& maxInterval)
         std::pair<Atom, SISet > pair(*atom, set);
         amap_.insert(pair);
     }
+    recomputeFingerprint();
+    renewVersions();
 }
 
 Model::Model(const boost::unordered_map<Proposition, SISet>& partialModel, const Interval& maxInterval)
-    : amap_(), maxInterval_(maxInterval) {
+    : amap_(), versions_(), maxInterval_(maxInterval), fingerprint_(0) {
     for(boost::unordered_map<Proposition, SISet>::const_iterator it = partialModel.begin();
             it != partialModel.end(); it++) {
         if (amap_.count(it->first.atom()) == 0) {
@@ -63,6 +71,8 @@ Model::Model(const boost::unordered_map<Proposition, SISet>& partialModel, const
             amap_.at(it->first.atom()).subtract(it->second);
         }
     }
+    recomputeFingerprint();
+    renewVersions();
 }
 
 /*
@@ -92,27 +102,40 @@ void Model::setAtom(const Atom& a, const SISet &set) {
     // check to see if atom is in the map
     if (hasAtom(a)) {
         SISet current = amap_.at(a);
+        fingerprint_ ^= fingerprintOf(a, current);
         current.add(set);
         // replace the previous element
         amap_.erase(a);
         amap_.insert(std::pair<const Atom, SISet>(a,current));
+        fingerprint_ ^= fingerprintOf(a, current);
     } else {
         amap_.insert(std::pair<const Atom, SISet>(a,set));
+        fingerprint_ ^= fingerprintOf(a, set);
     }
+    versions_[a] = nextVersion();
 }
 
 void Model::unsetAtom(const Atom& a, const SISet &set) {
     if (!hasAtom(a)) return;
     SISet current = amap_.at(a);
+    fingerprint_ ^= fingerprintOf(a, current);
     current.subtract(set);
     amap_.erase(a);
     if (current.size() != 0) {
         amap_.insert(std::pair<const Atom, SISet>(a, current));
+        fingerprint_ ^= fingerprintOf(a, current);
+        versions_[a] = nextVersion();
+    } else {
+        versions_.erase(a);
     }
 }
 
 void Model::clearAtom(const Atom& a) {
+    atom_map::const_iterator it = amap_.find(a);
+    if (it == amap_.end()) return;
+    fingerprint_ ^= fingerprintOf(it->first, it->second);
     amap_.erase(a);
+    versions_.erase(a);
 }
 
 
@@ -128,6 +151,8 @@ void Model::setMaxInterval(const Interval& maxInterval) {
     }
 
     amap_.swap(resized);
+    recomputeFingerprint();
+    renewVersions();
 }
 
 void Model::subtract(const Model& toSubtract) {
@@ -141,6 +166,8 @@ void Model::subtract(const Model& toSubtract) {
         }
         if (set.size() != 0) amap_.insert(std::pair<Atom, SISet>(a, set));
     }
+    recomputeFingerprint();
+    renewVersions();
 }
 
 void Model::intersect(const Model& b) {
@@ -154,6 +181,26 @@ void Model::intersect(const Model& b) {
             if (intersect.size() != 0) amap_.insert(std::pair<Atom, SISet>(atom, intersect));
         }
     }
+    recomputeFingerprint();
+    renewVersions();
+}
+
+void Model::recomputeFingerprint() {
+    fingerprint_ = 0;
+    for (atom_map::const_iterator it = amap_.begin(); it != amap_.end(); it++) {
+        fingerprint_ ^= fingerprintOf(it->first, it->second);
+    }
+}
+
+boost::uint64_t Model::nextVersion() {
+    return static_cast<boost::uint64_t>(++versionCounter);
+}
+
+void Model::renewVersions() {
+    versions_.clear();
+    for (atom_map::const_iterator it = amap_.begin(); it != amap_.end(); it++) {
+        versions_.insert(std::make_pair(it->first, nextVersion()));
+    }
 }
 
 unsigned long Model::size() const {
@@ -9,6 +9,7 @@
 #define MODEL_H_
 
 #include <boost/unordered_map.hpp>
+#include <boost/cstdint.hpp>
 #include <utility>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/map.hpp>
@@ -32,6 +33,9 @@ public:
 
     friend std::size_t hash_value(const Model& m);
 
+    const_iterator begin() const;
+    const_iterator end() const;
+
     bool hasAtom(const Atom& a) const;
 
     SISet getAtom(const Atom& a) const;
@@ -46,7 +50,32 @@ public:
     void intersect(const Model& b);
 
     unsigned long size() const;
-    void swap(Model& b) { amap_.swap(b.amap_); };
+
+    /**
+     * Get an order-independent fingerprint of the atoms in this model.  The
+     * fingerprint is the XOR of a mixed hash of every (Atom, SISet) pair and
+     * is maintained incrementally by setAtom(), unsetAtom() and clearAtom(),
+     * so it is O(1) to retrieve.  Equal models always have equal
+     * fingerprints; unequal fingerprints imply unequal models.
+     *
+     * @return  a 64-bit fingerprint of the atom map
+     */
+    boost::uint64_t fingerprint() const;
+
+    /**
+     * Get the version of an atom's value in this model.  Every change to an
+     * atom (setAtom(), unsetAtom(), clearAtom(), or any operation that
+     * rewrites the whole model) gives it a new version, drawn from a counter
+     * shared by all models, while copying a model keeps the versions.  So if
+     * two models give an atom the same version, the atom has the same value
+     * in both.  Atoms that aren't in the model have version 0.
+     *
+     * @param a  the atom to look up
+     * @return  the atom's current version
+     */
+    boost::uint64_t atomVersion(const Atom& a) const;
+
+    void swap(Model& b) { amap_.swap(b.amap_); versions_.swap(b.versions_); std::swap(maxInterval_, b.maxInterval_); std::swap(fingerprint_, b.fingerprint_); };
     std::string toString() const;
     /*
     bool operator ==(const Model& a) const;
@@ -56,7 +85,7 @@ public:
     friend bool operator!=(const Model& l, const Model& r);
 
     friend std::ostream& operator<<(std::ostream& out, const Model& m);
-    Model& operator=(const Model& m) { if (this != &m) amap_ = m.amap_; return *this;}   // TODO: use swap() dogg
+    Model& operator=(const Model& m) { if (this != &m) {amap_ = m.amap_; versions_ = m.versions_; maxInterval_ = m.maxInterval_; fingerprint_ = m.fingerprint_;} return *this;}   // TODO: use swap() dogg
 
 
 private:
@@ -72,25 +101,56 @@ private:
 */
     typedef boost::unordered_map<Atom, SISet> atom_map;
 
+    // the contribution of a single (atom, set) pair to the fingerprint
+    static boost::uint64_t fingerprintOf(const Atom& a, const SISet& set);
+    void recomputeFingerprint();
+    // give every atom a fresh version, after the whole map was rewritten
+    void renewVersions();
+    static boost::uint64_t nextVersion();
+
     atom_map amap_;
+    boost::unordered_map<Atom, boost::uint64_t> versions_;
     Interval maxInterval_;
+    boost::uint64_t fingerprint_;
 };
 
 // IMPLEMENTATION
 inline Model::Model()
-    : amap_(), maxInterval_(0,0) {}
+    : amap_(), versions_(), maxInterval_(0,0), fingerprint_(0) {}
 inline Model::Model(const Interval& maxInterval)
-    : amap_(), maxInterval_(maxInterval) {}
+    : amap_(), versions_(), maxInterval_(maxInterval), fingerprint_(0) {}
 
 
+inline Model::const_iterator Model::begin() const {return amap_.begin();}
+inline Model::const_iterator Model::end() const {return amap_.end();}
 inline Interval Model::maxInterval() const {return maxInterval_;}
+inline boost::uint64_t Model::fingerprint() const {return fingerprint_;}
+
+inline boost::uint64_t Model::atomVersion(const Atom& a) const {
+    boost::unordered_map<Atom, boost::uint64_t>::const_iterator it = versions_.find(a);
+    if (it == versions_.end()) return 0;
+    return it->second;
+}
 
-inline bool operator==(const Model& l, const Model& r) {return l.amap_ == r.amap_ && l.maxInterval_ == r.maxInterval_;}
+inline boost::uint64_t Model::fingerprintOf(const Atom& a, const SISet& set) {
+    std::size_t seed = hash_value(a);
+    boost::hash_combine(seed, set);
+    // finalize with the splitmix64 mixer so XOR-ing pairs doesn't cancel out
+    boost::uint64_t z = static_cast<boost::uint64_t>(seed) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline bool operator==(const Model& l, const Model& r) {
+    if (l.fingerprint_ != r.fingerprint_) return false;
+    return l.amap_ == r.amap_ && l.maxInterval_ == r.maxInterval_;
+}
 inline bool operator!=(const Model& l, const Model& r) {return !operator==(l, r);}
 
 inline std::size_t hash_value(const Model& m) {
     std::size_t seed = 0;
-    boost::hash_range(seed, m.amap_.begin(), m.amap_.end());
+    boost::hash_combine(seed, m.fingerprint_);
     boost::hash_combine(seed, m.maxInterval_);
     return seed;
 }
@@ -99,6 +159,11 @@ template <class Archive>
 void Model::serialize(Archive& ar, const unsigned int version) {
     ar & amap_;
     ar & maxInterval_;
+    // the fingerprint and versions aren't archived; rebuild them when loading
+    if (Archive::is_loading::value) {
+        recomputeFingerprint();
+        renewVersions();
+    }
 }
 /*
 template <class Archive>
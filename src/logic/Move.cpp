@@ -0,0 +1,52 @@
+/*
+ * Move.cpp
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include <boost/optional.hpp>
+#include "Move.h"
+#include "Domain.h"
+
+namespace {
+    Domain::atom_id idOf(const Domain& d, const Atom& a) {
+        boost::optional<Domain::atom_id> id = d.atomId(a);
+        if (!id) throw std::invalid_argument("cannot make a move for atom " + a.toString() + ", which isn't in the domain");
+        return id.get();
+    }
+
+    void changesToString(const Domain& d, Move::change_const_iterator begin, Move::change_const_iterator end, std::stringstream& str) {
+        for (Move::change_const_iterator it = begin; it != end; it++){
+            if (it != begin) str << ", ";
+            str << d.atomById(it->atom).toString() << " @ " << it->where.toString();
+        }
+    }
+}
+
+void Move::add(const Domain& d, const Atom& a, const SpanInterval& where) {
+    add(idOf(d, a), where);
+}
+
+void Move::del(const Domain& d, const Atom& a, const SpanInterval& where) {
+    del(idOf(d, a), where);
+}
+
+void Move::append(const Move& m) {
+    changes_.insert(changes_.begin() + numAdds_, m.adds_begin(), m.adds_end());
+    numAdds_ += m.adds_size();
+    changes_.insert(changes_.end(), m.dels_begin(), m.dels_end());
+}
+
+std::string Move::toString(const Domain& d) const {
+    std::stringstream str;
+
+    str << "toAdd: {";
+    changesToString(d, adds_begin(), adds_end(), str);
+    str << "}, ";
+
+    str << "toDel: {";
+    changesToString(d, dels_begin(), dels_end(), str);
+    str << "}";
+
+    return str.str();
+}
@@ -0,0 +1,111 @@
+/*
+ * Move.h
+ */
+
+#ifndef MOVE_H_
+#define MOVE_H_
+
+#include <cstddef>
+#include <string>
+#include <boost/container/small_vector.hpp>
+#include "../SpanInterval.h"
+#include "Domain.h"
+
+/**
+ * A change to a model: span intervals to make atoms true over (adds) and
+ * span intervals to make them false over (deletes).
+ *
+ * Atoms are referred to by their id in the domain the move was made for (see
+ * Domain::atomId()) rather than copied, and a move's changes are kept in one
+ * array, adds first, that only goes to the heap when there are more than a
+ * few of them.  Since most moves touch one to three atoms, making and copying
+ * them doesn't allocate.
+ */
+class Move {
+public:
+    struct Change {
+        Change();
+        Change(Domain::atom_id atom, const SpanInterval& where);
+
+        Domain::atom_id atom;   // the atom's id in the domain
+        SpanInterval where;
+    };
+    typedef boost::container::small_vector<Change, 4> change_list;
+    typedef change_list::const_iterator change_const_iterator;
+
+    Move();
+    Move(const Move& m);
+    Move& operator=(const Move& m);
+
+    /**
+     * Make an atom true over a span interval.
+     */
+    void add(Domain::atom_id atom, const SpanInterval& where);
+    void add(const Domain& d, const Atom& a, const SpanInterval& where);
+
+    /**
+     * Make an atom false over a span interval.
+     */
+    void del(Domain::atom_id atom, const SpanInterval& where);
+    void del(const Domain& d, const Atom& a, const SpanInterval& where);
+
+    /**
+     * Append all the adds and deletes of another move to this one.
+     */
+    void append(const Move& m);
+
+    // every change, adds first
+    change_const_iterator changes_begin() const;
+    change_const_iterator changes_end() const;
+    change_const_iterator adds_begin() const;
+    change_const_iterator adds_end() const;
+    change_const_iterator dels_begin() const;
+    change_const_iterator dels_end() const;
+
+    std::size_t adds_size() const;
+    std::size_t dels_size() const;
+    bool isEmpty() const;
+
+    /**
+     * Describe this move, looking up the names of its atoms in d.  Only call
+     * this when the result is going to be logged.
+     */
+    std::string toString(const Domain& d) const;
+private:
+    change_list changes_;
+    std::size_t numAdds_;
+};
+
+// IMPLEMENTATION
+inline Move::Change::Change() : atom(0), where(0, 0, 0, 0) {}
+inline Move::Change::Change(Domain::atom_id atom, const SpanInterval& where) : atom(atom), where(where) {}
+
+inline Move::Move() : changes_(), numAdds_(0) {}
+inline Move::Move(const Move& m) : changes_(m.changes_), numAdds_(m.numAdds_) {}
+
+inline Move& Move::operator=(const Move& m) {
+    changes_ = m.changes_;
+    numAdds_ = m.numAdds_;
+    return *this;
+}
+
+inline void Move::add(Domain::atom_id atom, const SpanInterval& where) {
+    changes_.insert(changes_.begin() + numAdds_, Change(atom, where));
+    numAdds_++;
+}
+
+inline void Move::del(Domain::atom_id atom, const SpanInterval& where) {
+    changes_.push_back(Change(atom, where));
+}
+
+inline Move::change_const_iterator Move::changes_begin() const { return changes_.begin();}
+inline Move::change_const_iterator Move::changes_end() const { return changes_.end();}
+inline Move::change_const_iterator Move::adds_begin() const { return changes_.begin();}
+inline Move::change_const_iterator Move::adds_end() const { return changes_.begin() + numAdds_;}
+inline Move::change_const_iterator Move::dels_begin() const { return changes_.begin() + numAdds_;}
+inline Move::change_const_iterator Move::dels_end() const { return changes_.end();}
+inline std::size_t Move::adds_size() const { return numAdds_;}
+inline std::size_t Move::dels_size() const { return changes_.size() - numAdds_;}
+inline bool Move::isEmpty() const { return changes_.empty();}
+
+#endif /* MOVE_H_ */
@@ -21,43 +21,26 @@
 #include "NameGenerator.h"
 
 
-std::string Move::toString() const {
-    std::stringstream str;
-
-    str << "toAdd: {";
-    for (std::vector<Move::change>::const_iterator it = toAdd.begin(); it != toAdd.end(); it++){
-        if (it != toAdd.begin()) str << ", ";
-        str << it->get<0>().toString() << " @ " << it->get<1>().toString();
-    }
-    str << "}, ";
-
-    str << "toDel: {";
-    for (std::vector<Move::change>::const_iterator it = toDel.begin(); it != toDel.end(); it++){
-        if (it != toDel.begin()) str << ", ";
-        str << it->get<0>().toString() << " @ " << it->get<1>().toString();
-    }
-    str << "}";
-
-    return str.str();
-}
-
-bool Move::isEmpty() const {
-    return (toAdd.size() == 0 && toDel.size() == 0);
-}
-
-bool canFindMovesFor(const Sentence &s, const Domain &d) {
-    if (dynamic_cast<const LiquidOp *>(&s)) {
-        return true;        // this isn't really fair: TODO write a better test on liquid ops
+MoveGenerator::MoveGenerator(const Sentence& s, const Domain& d) : kind_(NONE) {
+    if (s.getTypeCode() == LiquidOp::TypeCode) {
+        kind_ = LIQUID;        // this isn't really fair: TODO write a better test on liquid ops
+    } else if (s.getTypeCode() == Cardinality::TypeCode) {
+        kind_ = CARDINALITY;
     } else if (isFormula1Type(s, d)) {
-        return true;
+        kind_ = FORM1;
     } else if (isFormula2Type(s, d)) {
-        return true;
+        kind_ = FORM2;
     } else if (isFormula3Type(s, d)) {
-        return true;
-    } else if (isPELCNFLiteral(s) || isDisjunctionOfPELCNFLiterals(s)) {
-        return true;
+        kind_ = FORM3;
+    } else if (isPELCNFLiteral(s)) {
+        kind_ = PELCNF_LITERAL;
+    } else if (isDisjunctionOfPELCNFLiterals(s)) {
+        kind_ = PELCNF_DISJUNCTION;
     }
-    return false;
+}
+
+bool canFindMovesFor(const Sentence &s, const Domain &d) {
+    return MoveGenerator(s, d).canFindMoves();
 }
 
 bool isFormula1Type(const Sentence &s, const Domain &d) {
@@ -828,14 +811,12 @@ Move findMovesForLiquidLiteral(const Domain& d, const Model& m, const Sentence &
         if (isNegation) {
             // we want to delete span intervals where its true
             BOOST_FOREACH(SpanInterval toModifySi, toModify.asSet()) {
-                Move::change change = boost::make_tuple(*a, toModifySi);
-                move.toDel.push_back(change);
+                move.del(d, *a, toModifySi);
             }
         } else {
             BOOST_FOREACH(SpanInterval toModifySi, toModify.asSet()) {
                 // we want to add span intervals where its false
-                Move::change change = boost::make_tuple(*a, toModifySi);
-                move.toAdd.push_back(change);
+                move.add(d, *a, toModifySi);
             }
         }
     }
@@ -878,12 +859,10 @@ Move findMovesForLiquidConjunction(const Domain& d, const Model& m, const Conjun
         if (dynamic_cast<const Negation*>(s)) {
             const Negation* n = dynamic_cast<const Negation*>(s);
             const Atom* a = dynamic_cast<const Atom*>(&(*n->sentence()));
-            Move::change change = boost::make_tuple(*a, si);
-            move.toDel.push_back(change);
+            move.del(d, *a, si);
         } else {
             const Atom* a = dynamic_cast<const Atom*>(s);
-            Move::change change = boost::make_tuple(*a, si);
-            move.toAdd.push_back(change);
+            move.add(d, *a, si);
         }
     }
     return move;
@@ -900,6 +879,42 @@ std::vector<Move> findMovesForLiquidDisjunction(const Domain& d, const Model& m,
     return moves;
 }
 
+std::vector<Move> findMovesForCardinality(const Domain& d, const Model& m, const Cardinality &c, const SpanInterval& si) {
+    std::vector<Move> moves;
+    SpanInterval toModify = si;
+    if (!toModify.isLiquid()) {
+        toModify = toModify.toLiquidInc();
+    }
+
+    // only the atoms true somewhere in si need deleting
+    std::vector<bool> trueIn(c.atoms().size(), false);
+    for (std::size_t i = 0; i < c.atoms().size(); i++) {
+        trueIn[i] = !intersection(c.atoms()[i]->satisfied(m, d, true), toModify).empty();
+    }
+
+    // one move for each atom that could be the one left true over si
+    for (std::size_t i = 0; i < c.atoms().size(); i++) {
+        if (c.kind() == Cardinality::AT_MOST_ONE && !trueIn[i]) continue;
+        Move move;
+        if (c.kind() == Cardinality::EXACTLY_ONE) {
+            move.add(d, *c.atoms()[i], toModify);
+        }
+        for (std::size_t j = 0; j < c.atoms().size(); j++) {
+            if (j != i && trueIn[j]) move.del(d, *c.atoms()[j], toModify);
+        }
+        if (!move.isEmpty()) moves.push_back(move);
+    }
+    // at most one is also satisfied by none of them
+    if (c.kind() == Cardinality::AT_MOST_ONE) {
+        Move move;
+        for (std::size_t j = 0; j < c.atoms().size(); j++) {
+            if (trueIn[j]) move.del(d, *c.atoms()[j], toModify);
+        }
+        if (!move.isEmpty()) moves.push_back(move);
+    }
+    return moves;
+}
+
 std::vector<Move> findMovesForLiquid(const Domain& d, const Model& m, const Sentence &s, const SpanInterval& si) {
     SpanInterval toModify = si;
     if (!toModify.isLiquid()) {
@@ -918,78 +933,113 @@ std::vector<Move> findMovesForLiquid(const Domain& d, const Model& m, const Sent
         const Disjunction* dis = dynamic_cast<const Disjunction *>(&s);
         std::vector<Move> disMoves = findMovesForLiquidDisjunction(d, m, *dis, toModify);
         moves.insert(moves.end(), disMoves.begin(), disMoves.end());
+    } else if (s.getTypeCode() == Cardinality::TypeCode) {
+        moves = findMovesForCardinality(d, m, static_cast<const Cardinality&>(s), toModify);
     }
     return moves;
 }
 
 
 std::vector<Move> findMovesFor(const Domain& d, const Model& m, const ELSentence &el, boost::mt19937& rng) {
+    return MoveGenerator(*el.sentence(), d).findMoves(d, m, el, rng);
+}
+
+namespace {
+    // where el is true (or false), through d's compiled program when el is
+    // formula *formulaId of d
+    SISet satisfiedAt(const Domain& d, const Model& m, const ELSentence& el, const std::size_t* formulaId) {
+        if (formulaId == NULL) return el.dSatisfied(m, d);
+        SentenceProgram::Registers regs;
+        return d.dSatisfied(*formulaId, m, regs);
+    }
+
+    SISet notSatisfiedAt(const Domain& d, const Model& m, const ELSentence& el, const std::size_t* formulaId) {
+        if (formulaId == NULL) return el.dNotSatisfied(m, d);
+        SentenceProgram::Registers regs;
+        return d.dNotSatisfied(*formulaId, m, regs);
+    }
+}
+
+std::vector<Move> MoveGenerator::findMoves(const Domain& d, const Model& m, const ELSentence& el, boost::mt19937& rng) const {
+    return findMoves(d, m, el, NULL, rng);
+}
+
+std::vector<Move> MoveGenerator::findMoves(const Domain& d, const Model& m, std::size_t formulaId, boost::mt19937& rng) const {
+    return findMoves(d, m, d.formulas_begin()[formulaId], &formulaId, rng);
+}
+
+std::vector<Move> MoveGenerator::findMoves(const Domain& d, const Model& m, const ELSentence& el,
+        const std::size_t* formulaId, boost::mt19937& rng) const {
     std::vector<Move> moves;
     const Sentence& s = *el.sentence();
-    if (dynamic_cast<const LiquidOp*>(&s)) {
+    switch (kind_) {
+    case LIQUID: {
         // pick an si to satisfy
-        SISet sat = el.dSatisfied(m, d);
+        SISet sat = satisfiedAt(d, m, el, formulaId);
         sat.setForceLiquid(true);
         LOG(LOG_DEBUG) << "sentence " << el << " satisfied at " << sat.toString();
-        //SISet notSat = el.dNotSatisfied(m, d);
-        //notSat.setForceLiquid(true);
         SISet notSat = sat.compliment();
         if (notSat.size() == 0) return moves;
 
         SpanInterval si = notSat.randomSI(rng);
         LOG(LOG_DEBUG) << "choosing " << si.toString() << " as the interval to satisfy";
-        const LiquidOp* liq = dynamic_cast<const LiquidOp*>(&s);
-        moves = findMovesForLiquid(d, m, *liq->sentence(), si);
-    } else if (isFormula1Type(s, d)) {
-        moves = findMovesForForm1(d, m, dynamic_cast<const Disjunction&>(s), rng);   // TODO: fix so it uses ELSentence
-    } else if (isFormula2Type(s, d)) {
-        moves = findMovesForForm2(d, m, dynamic_cast<const Disjunction&>(s), rng);// TODO: fix so it uses ELSentence
-    } else if (isFormula3Type(s, d)) {
-        moves = findMovesForForm3(d, m, dynamic_cast<const Disjunction&>(s), rng);// TODO: fix so it uses ELSentence
-    } else if (isPELCNFLiteral(s)) {
+        moves = findMovesForLiquid(d, m, *static_cast<const LiquidOp&>(s).sentence(), si);
+        break;
+    }
+    case CARDINALITY: {
+        // like a liquid op, pick one interval where the count is wrong
+        SISet sat = satisfiedAt(d, m, el, formulaId);
+        sat.setForceLiquid(true);
+        SISet notSat = sat.compliment();
+        if (notSat.size() == 0) return moves;
+
+        SpanInterval si = notSat.randomSI(rng);
+        moves = findMovesForCardinality(d, m, static_cast<const Cardinality&>(s), si);
+        break;
+    }
+    case FORM1:
+        moves = findMovesForForm1(d, m, static_cast<const Disjunction&>(s), rng);   // TODO: fix so it uses ELSentence
+        break;
+    case FORM2:
+        moves = findMovesForForm2(d, m, static_cast<const Disjunction&>(s), rng);// TODO: fix so it uses ELSentence
+        break;
+    case FORM3:
+        moves = findMovesForForm3(d, m, static_cast<const Disjunction&>(s), rng);// TODO: fix so it uses ELSentence
+        break;
+    case PELCNF_LITERAL: {
         // pick an si to satisfy
-        SISet notSat = el.dNotSatisfied(m, d);
+        SISet notSat = notSatisfiedAt(d, m, el, formulaId);
         if (notSat.size() == 0) return moves;
 
         SpanInterval si = notSat.randomSI(rng);
         moves = findMovesForPELCNFLiteral(d, m, s, si, rng);
-    } else if (isDisjunctionOfPELCNFLiterals(s)) {
+        break;
+    }
+    case PELCNF_DISJUNCTION: {
         // instead of choosing just one si, we'll try them all
-        SISet sat = el.dSatisfied(m, d);
-        LOG(LOG_DEBUG) << "sentence true at :" << sat.toString();
-        SISet notSat = el.dNotSatisfied(m, d);
+        SISet notSat = notSatisfiedAt(d, m, el, formulaId);
         LOG(LOG_DEBUG) << "sentence NOT true at :" << notSat.toString();
 
         if (notSat.size() == 0) return moves;
 
         BOOST_FOREACH(SpanInterval si, notSat.asSet()) {
-            std::vector<Move> localMoves = findMovesForPELCNFDisjunction(d, m, dynamic_cast<const Disjunction&>(s), si, rng);
+            std::vector<Move> localMoves = findMovesForPELCNFDisjunction(d, m, static_cast<const Disjunction&>(s), si, rng);
             moves.insert(moves.end(), localMoves.begin(), localMoves.end());
         }
-
-    } else {
+        break;
+    }
+    default:
         LOG_PRINT(LOG_ERROR) << "given sentence \"" << s.toString() << "\" but it doesn't match any moves function we know about!";
     }
     // ensure that if we aren't allowed to modify predicates, we don't!
-    // TODO: remove this later as an optimization step
     for (std::vector<Move>::iterator it = moves.begin(); it != moves.end(); ) {
         bool removeIt = false;
-        std::vector<Move::change> allMoves = it->toAdd;
-        std::copy(it->toDel.begin(), it->toDel.end(), std::back_inserter(allMoves));
-
-        for (std::vector<Move::change>::iterator it2 = allMoves.begin(); it2 != allMoves.end(); it2++) {
-            Atom a = it2->get<0>();
-            SpanInterval where = it2->get<1>();
-            SISet asSet(where, false, d.maxInterval());
-            SISet mod = d.getModifiableSISet(a, asSet);
-            if (asSet != mod) {
-                removeIt = true;
-                break;
-            }
+        for (Move::change_const_iterator it2 = it->changes_begin(); !removeIt && it2 != it->changes_end(); it2++) {
+            if (!d.isModifiable(d.atomById(it2->atom), it2->where)) removeIt = true;
         }
 
         if (removeIt) {
-            LOG_PRINT(LOG_WARN) << "tried to modify an observed atom with move: " + it->toString() << " .  Removing it.";
+            LOG(LOG_WARN) << "tried to modify an observed atom with move: " << it->toString(d) << " .  Removing it.";
             it = moves.erase(it);
         } else {
             it++;
@@ -1024,9 +1074,9 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
         if (d.isLiquid(a->name()) && !si.isLiquid()) {
             // need to add it to a liquid spaninterval
             SpanInterval si2(si.start().start(), si.finish().finish(), si.start().start(), si.finish().finish());
-            move.toAdd.push_back(boost::make_tuple(*a, si2));
+            move.add(d, *a, si2);
         } else {
-            move.toAdd.push_back(boost::make_tuple(*a, si));
+            move.add(d, *a, si);
         }
         moves.push_back(move);
         return moves;
@@ -1046,9 +1096,9 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
             Move move;
             if (d.isLiquid(a->name()) && !si.isLiquid()) {
                 SpanInterval si2(si.start().start(), si.finish().finish(), si.start().start(), si.finish().finish());
-                move.toDel.push_back(boost::make_tuple(*a, si2));
+                move.del(d, *a, si2);
             } else {
-                move.toDel.push_back(boost::make_tuple(*a, si));
+                move.del(d, *a, si);
             }
             moves.push_back(move);
             return moves;
@@ -1059,9 +1109,9 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
                 Move move;
                 if (d.isLiquid(a->name()) && !si.isLiquid()) {
                     SpanInterval si2(si.start().start(), si.finish().finish(), si.start().start(), si.finish().finish());
-                    move.toAdd.push_back(boost::make_tuple(*a, si2));
+                    move.add(d, *a, si2);
                 } else {
-                    move.toAdd.push_back(boost::make_tuple(*a, si));
+                    move.add(d, *a, si);
                 }
                 moves.push_back(move);
                 return moves;
@@ -1073,7 +1123,7 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
                         // We've got !<>{*}, this is easy
                         Move move;
                         SpanInterval everywhere(d.maxInterval(), d.maxInterval());
-                        move.toAdd.push_back(boost::make_tuple(*a, everywhere));
+                        move.add(d, *a, everywhere);
                         moves.push_back(move);
                         return moves;
                     }
@@ -1089,8 +1139,7 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
                         if (siRel) {
                             std::vector<Move> localMoves = findMovesForPELCNFLiteral(d, m, *negatedInside->sentence(), siRel.get(), rng);
                             BOOST_FOREACH(Move localMove, localMoves) {
-                                move.toAdd.insert(move.toAdd.end(), localMove.toAdd.begin(), localMove.toAdd.end());
-                                move.toDel.insert(move.toAdd.end(), localMove.toDel.begin(), localMove.toDel.end());
+                                move.append(localMove);
                             }
                         }
                         moves.push_back(move);
@@ -1108,9 +1157,9 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
                     Move move;
                     if (d.isLiquid(a->name()) && !si2.isLiquid()) {
                         SpanInterval si3(si2.start().start(), si2.finish().finish(), si2.start().start(), si2.finish().finish());
-                        move.toDel.push_back(boost::make_tuple(*a, si3));
+                        move.del(d, *a, si3);
                     } else {
-                        move.toDel.push_back(boost::make_tuple(*a, si2));
+                        move.del(d, *a, si2);
                     }
                     moves.push_back(move);
                     return moves;
@@ -1135,7 +1184,7 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
                     // We've got !<>{*}, this is easy
                     Move move;
                     SpanInterval everywhere(d.maxInterval(), d.maxInterval());
-                    move.toDel.push_back(boost::make_tuple(*a, everywhere));
+                    move.del(d, *a, everywhere);
                     moves.push_back(move);
                     return moves;
                 }
@@ -1159,9 +1208,9 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
                 Move move;
                 if (d.isLiquid(a->name()) && !si2.isLiquid()) {
                     SpanInterval si3(si2.start().start(), si2.finish().finish(), si2.start().start(), si2.finish().finish());
-                    move.toDel.push_back(boost::make_tuple(*a, si3));
+                    move.del(d, *a, si3);
                 } else {
-                    move.toDel.push_back(boost::make_tuple(*a, si2));
+                    move.del(d, *a, si2);
                 }
                 moves.push_back(move);
                 return moves;
@@ -1210,7 +1259,7 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
                             Interval inter = interOpt.get();
                             // remove that part of the spanning interval
                             SpanInterval siToRemove(inter.start(), leftSi.finish().finish(), inter.start(), leftSi.finish().finish());
-                            move.toDel.push_back(boost::make_tuple(*leftAtom, siToRemove));
+                            move.del(d, *leftAtom, siToRemove);
                         }
                     }
                     if (!move.isEmpty()) moves.push_back(move);
@@ -1224,7 +1273,7 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
                             Interval inter = interOpt.get();
                             // remove that part of the spanning interval
                             SpanInterval siToRemove(rightSi.start().start(), inter.finish(), rightSi.start().start(), inter.finish());
-                            move.toDel.push_back(boost::make_tuple(*rightAtom, siToRemove));
+                            move.del(d, *rightAtom, siToRemove);
                         }
                     }
                     if (!move.isEmpty()) moves.push_back(move);
@@ -1284,7 +1333,7 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
             boost::uniform_int<unsigned int> pointPick(durInt.start().start(), durInt.start().finish());
             unsigned int point = pointPick(rng);
             Move move;
-            move.toAdd.push_back(boost::make_tuple(*a, SpanInterval(point, point, point, point)));
+            move.add(d, *a, SpanInterval(point, point, point, point));
             moves.push_back(move);
             return moves;
         }
@@ -1299,18 +1348,18 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
             if (insideSatisfiedAt.size() == 0) {
                 // just add it at the beginning
                 Move move;
-                move.toAdd.push_back(boost::make_tuple(*a,
-                        SpanInterval(j, j, j, j)));
+                move.add(d, *a,
+                        SpanInterval(j, j, j, j));
                 moves.push_back(move);
                 return moves;
             } else {
                 SpanInterval mostRecent = set_at(insideSatisfiedAt.asSet(), insideSatisfiedAt.asSet().size()-1);
                 Move move;
-                move.toAdd.push_back(boost::make_tuple(*a,
+                move.add(d, *a,
                         SpanInterval(mostRecent.finish().finish()+1,
                                 j,
                                 mostRecent.finish().finish()+1,
-                                j)));
+                                j));
                 moves.push_back(move);
                 return moves;
             }
@@ -1326,18 +1375,18 @@ std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, con
             if (insideSatisfiedAt.size() == 0) {
                 // just add it at the end
                 Move move;
-                move.toAdd.push_back(boost::make_tuple(*a,
-                        SpanInterval(j, j, j, j)));
+                move.add(d, *a,
+                        SpanInterval(j, j, j, j));
                 moves.push_back(move);
                 return moves;
             } else {
                 SpanInterval mostRecent = set_at(insideSatisfiedAt.asSet(), 0);
                 Move move;
-                move.toAdd.push_back(boost::make_tuple(*a,
+                move.add(d, *a,
                         SpanInterval(j,
                                 mostRecent.start().start(),
                                 j,
-                                mostRecent.start().start())));
+                                mostRecent.start().start()));
                 moves.push_back(move);
                 return moves;
             }
@@ -1375,50 +1424,20 @@ std::vector<Move> findMovesForPELCNFDisjunction(const Domain &d, const Model& m,
 Model executeMove(const Domain& d, const Move& move, const Model& model) {
     Model currentModel = model;
     // handle toadd
-    for (std::vector<Move::change>::const_iterator it = move.toAdd.begin(); it != move.toAdd.end(); it++) {
-        // check to see if atom is in the map; if not we will add it
-        /*
-        Model::iterator modelIt = currentModel.find(it->get<0>());
-        if (modelIt != currentModel.end()) {
-            const Atom a = modelIt->first;
-            SISet trueAt = modelIt->second;
-            trueAt.add(it->get<1>());
-            currentModel.erase(modelIt);
-            currentModel.insert(std::pair<const Atom, SISet>(a, trueAt));
-        } else {
-            bool isLiquid = d.isLiquid(it->get<0>().name());
-            SISet trueAt(isLiquid, d.maxInterval());
-            trueAt.add(it->get<1>());
-            currentModel.insert(std::pair<const Atom, SISet>(it->get<0>(), trueAt));
-        }
-        */
-        bool isLiquid = d.isLiquid(it->get<0>().name());
-        SISet trueAt(isLiquid, d.maxInterval());
-        trueAt.add(it->get<1>());
-        currentModel.setAtom(it->get<0>(), trueAt);
+    for (Move::change_const_iterator it = move.adds_begin(); it != move.adds_end(); it++) {
+        const Atom& a = d.atomById(it->atom);
+        SISet trueAt(d.isLiquid(a.name()), d.maxInterval());
+        trueAt.add(it->where);
+        currentModel.setAtom(a, trueAt);
     }
     // handle toDel
-    for (std::vector<Move::change>::const_iterator it = move.toDel.begin(); it != move.toDel.end(); it++) {
-        // check to see if atom is in the map; if not we are done
-        /*
-        Model::iterator modelIt = currentModel.find(it->get<0>());
-        if (modelIt != currentModel.end()) {
-            const Atom a = modelIt->first;
-            SISet trueAt = modelIt->second;
-
-            SISet toRemoveComp(trueAt.forceLiquid(), trueAt.maxInterval());
-            toRemoveComp.add(it->get<1>());
-            toRemoveComp = toRemoveComp.compliment();
-            trueAt = intersection(trueAt, toRemoveComp);
-
-            currentModel.erase(modelIt);
-            if (trueAt.size() > 0) currentModel.insert(std::pair<const Atom, SISet>(a, trueAt));
-        }
-        */
-        if (currentModel.hasAtom(it->get<0>())) {
-            SISet toRemove(d.isLiquid(it->get<0>().name()), d.maxInterval());
-            toRemove.add(it->get<1>());
-            currentModel.unsetAtom(it->get<0>(), toRemove);
+    for (Move::change_const_iterator it = move.dels_begin(); it != move.dels_end(); it++) {
+        const Atom& a = d.atomById(it->atom);
+        // if the atom isn't in the model we are done
+        if (currentModel.hasAtom(a)) {
+            SISet toRemove(d.isLiquid(a.name()), d.maxInterval());
+            toRemove.add(it->where);
+            currentModel.unsetAtom(a, toRemove);
         }
     }
     return currentModel;
@@ -1428,7 +1447,20 @@ Model executeMove(const Domain& d, const Move& move, const Model& model) {
 boost::shared_ptr<Sentence> convertToPELCNF(const boost::shared_ptr<const Sentence>& sentence, std::vector<boost::shared_ptr<Sentence> >& supportSentences,  Domain &d) {
     // make a copy so we can modify it
     boost::shared_ptr<Sentence> copy(sentence->clone());
-    return convertToPELCNF_(copy, supportSentences, d);
+    std::size_t firstSupport = supportSentences.size();
+    boost::shared_ptr<Sentence> converted = convertToPELCNF_(copy, supportSentences, d);
+
+    // rewriting can leave constants and double negations behind
+    SentenceSimplifier simplifier;
+    converted = simplifier.simplify(converted);
+    for (std::size_t i = firstSupport; i < supportSentences.size(); i++) {
+        supportSentences[i] = simplifier.simplify(supportSentences[i]);
+    }
+    if (simplifier.eliminated() > 0) {
+        LOG(LOG_DEBUG) << "simplifying the PEL-CNF of " << sentence->toString()
+                << " eliminated " << simplifier.eliminated() << " nodes";
+    }
+    return converted;
 }
 
 boost::shared_ptr<Sentence> moveNegationsInward(const boost::shared_ptr<Sentence>& sentence) {
@@ -1551,37 +1583,14 @@ boost::shared_ptr<Sentence> moveNegationsInward(const boost::shared_ptr<Sentence
 
 bool moveContainsObservationPreds(const Domain& d, const Move &m) {
     // TODO: this is a bad solution!  come back and fix this!
-
-    for (std::vector<Move::change>::const_iterator it = m.toAdd.begin();
-            it != m.toAdd.end();
-            it++) {
-        //if (d.observedPredicates().find(it->get<0>().name()) != d.observedPredicates().end()) {
-        //  return true;
-        //}
-        SISet original(d.isLiquid(it->get<0>().name()), d.maxInterval());
-        original.add(it->get<1>());
-        SISet modifiable = d.getModifiableSISet(it->get<0>(), original);
+    for (Move::change_const_iterator it = m.changes_begin(); it != m.changes_end(); it++) {
+        const Atom& a = d.atomById(it->atom);
+        SISet original(d.isLiquid(a.name()), d.maxInterval());
+        original.add(it->where);
+        SISet modifiable = d.getModifiableSISet(a, original);
         if (modifiable.size() != original.size()) return true;
-
-       // if (it->get<0>().name().find("D-") == 0) return true;
     }
 
-    for (std::vector<Move::change>::const_iterator it = m.toDel.begin();
-            it != m.toDel.end();
-            it++) {
-        /*
-        if (d.observedPredicates().find(it->get<0>().name()) != d.observedPredicates().end()) {
-          return true;
-        }
-        if (it->get<0>().name().find("D-") == 0) return true;
-        */
-        SISet original(d.isLiquid(it->get<0>().name()), d.maxInterval());
-        original.add(it->get<1>());
-        SISet modifiable = d.getModifiableSISet(it->get<0>(), original);
-        if (modifiable.size() != original.size()) return true;
-    }
-
-
     return false;
 }
 
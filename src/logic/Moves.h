@@ -13,6 +13,7 @@
 #include <iterator>
 
 #include "../SISet.h"
+#include "Move.h"
 #include "Domain.h"
 #include "../util/Utils.h"
 #include "../Log.h"
@@ -21,15 +22,55 @@
 class LiquidOp;
 class Sentence;
 
-struct Move {
-    typedef boost::tuple <Atom, SpanInterval> change;
-    std::vector<change> toAdd;
-    std::vector<change> toDel;
+/**
+ * Generates moves for one formula.
+ *
+ * Which of the move functions below applies to a formula depends only on its
+ * shape, so a generator works that out once, when it is made, rather than
+ * every time moves are needed.  Make one per formula when the formulas are
+ * loaded and call findMoves() on each iteration.
+ */
+class MoveGenerator {
+public:
+    enum Kind {
+        NONE,               // no move function handles it
+        LIQUID,
+        CARDINALITY,
+        FORM1,
+        FORM2,
+        FORM3,
+        PELCNF_LITERAL,
+        PELCNF_DISJUNCTION
+    };
 
-    std::string toString() const;
-    bool isEmpty() const;
-};
+    MoveGenerator();
+    MoveGenerator(const Sentence& s, const Domain& d);
+
+    Kind kind() const;
+    bool canFindMoves() const;
+
+    /**
+     * Find the moves that improve el in m, leaving out any that modify an
+     * atom the domain doesn't allow to be changed.
+     *
+     * @param el  the formula this generator was made for
+     */
+    std::vector<Move> findMoves(const Domain& d, const Model& m, const ELSentence& el, boost::mt19937& rng) const;
 
+    /**
+     * Find the moves that improve formula formulaId of d, evaluating it
+     * with d's compiled program rather than walking the sentence.
+     *
+     * @param formulaId  the position in d of the formula this generator
+     *   was made for
+     */
+    std::vector<Move> findMoves(const Domain& d, const Model& m, std::size_t formulaId, boost::mt19937& rng) const;
+private:
+    std::vector<Move> findMoves(const Domain& d, const Model& m, const ELSentence& el,
+            const std::size_t* formulaId, boost::mt19937& rng) const;
+
+    Kind kind_;
+};
 
 bool canFindMovesFor(const Sentence &s, const Domain &d);
 bool isFormula1Type(const Sentence &s, const Domain &d);
@@ -43,6 +84,7 @@ std::vector<Move> findMovesForForm3(const Domain& d, const Model& m, const Disju
 Move findMovesForLiquidLiteral(const Domain& d, const Model& m, const Sentence &s, const SpanInterval& si);
 std::vector<Move> findMovesForLiquidDisjunction(const Domain& d, const Model& m, const Disjunction &dis, const SpanInterval &si);
 std::vector<Move> findMovesForLiquid(const Domain& d, const Model& m, const Sentence &s, const SpanInterval &si);
+std::vector<Move> findMovesForCardinality(const Domain& d, const Model& m, const Cardinality &c, const SpanInterval &si);
 std::vector<Move> findMovesForPELCNFLiteral(const Domain& d, const Model& m, const Sentence &s, const SpanInterval& si, boost::mt19937& rng);
 std::vector<Move> findMovesForPELCNFDisjunction(const Domain &d, const Model& m, const Disjunction &dis, const SpanInterval& si, boost::mt19937& rng);
 Model executeMove(const Domain& d, const Move& move, const Model& model);
@@ -52,6 +94,11 @@ boost::shared_ptr<Sentence> moveNegationsInward(const boost::shared_ptr<Sentence
 
 bool moveContainsObservationPreds(const Domain& d, const Move& m);
 
+// IMPLEMENTATION
+inline MoveGenerator::MoveGenerator() : kind_(NONE) {}
+inline MoveGenerator::Kind MoveGenerator::kind() const { return kind_;}
+inline bool MoveGenerator::canFindMoves() const { return kind_ != NONE;}
+
 namespace {
     boost::shared_ptr<Sentence> convertToPELCNF_(const boost::shared_ptr<Sentence>& curSentence, std::vector<boost::shared_ptr<Sentence> >& additionalSentences, Domain& d);
     boost::shared_ptr<Atom> rewriteAsLiteral(boost::shared_ptr<Sentence> sentence, std::vector<boost::shared_ptr<Sentence> >& additionalSentences, Domain& d);
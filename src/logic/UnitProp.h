@@ -8,7 +8,7 @@
 #ifndef UNIT_PROP_H_
 #define UNIT_PROP_H_
 
-#include "../util/shared_ptr.hpp"
+#include <boost/shared_ptr.hpp>
 #include <utility>
 #include <queue>
 #include <iostream>
@@ -0,0 +1,77 @@
+/*
+ * Cardinality.cpp
+ */
+
+#include <algorithm>
+#include <utility>
+#include "Cardinality.h"
+#include "../Domain.h"
+
+namespace {
+    typedef std::pair<unsigned int, int> Event; // a moment and the change in count there
+
+    // add the moments where a liquid set starts and stops being true,
+    // merging its overlapping and meeting parts first so no atom is counted
+    // twice at one moment
+    void addEvents(const SISet& set, std::vector<Event>& events) {
+        std::vector<std::pair<unsigned int, unsigned int> > runs;
+        for (SISet::const_iterator it = set.begin(); it != set.end(); it++) {
+            if (it->isEmpty()) continue;
+            runs.push_back(std::make_pair(it->start().start(), it->finish().finish()));
+        }
+        std::sort(runs.begin(), runs.end());
+        for (std::size_t i = 0; i < runs.size();) {
+            unsigned int start = runs[i].first;
+            unsigned int finish = runs[i].second;
+            for (i++; i < runs.size() && runs[i].first <= finish + 1; i++) {
+                finish = std::max(finish, runs[i].second);
+            }
+            events.push_back(Event(start, 1));
+            events.push_back(Event(finish + 1, -1));
+        }
+    }
+}
+
+void Cardinality::doToString(std::stringstream& str) const {
+    str << (kind_ == EXACTLY_ONE ? "ex1(" : "at1(");
+    for (std::vector<boost::shared_ptr<Atom> >::const_iterator it = atoms_.begin(); it != atoms_.end(); it++) {
+        if (it != atoms_.begin()) str << ", ";
+        str << (*it)->toString();
+    }
+    str << ")";
+}
+
+SISet Cardinality::satisfied(const Model& m, const Domain& d, bool forceLiquid) const {
+    Interval maxInterval = d.maxInterval();
+    std::vector<Event> events;
+    for (std::vector<boost::shared_ptr<Atom> >::const_iterator it = atoms_.begin(); it != atoms_.end(); it++) {
+        addEvents((*it)->satisfied(m, d, true), events);
+    }
+    std::sort(events.begin(), events.end());
+
+    // sweep the moments of the domain in order, keeping track of how many
+    // atoms are true and adding every maximal run the count is allowed in
+    SISet set(true, maxInterval);
+    int count = 0;
+    bool inRun = false;
+    unsigned int runStart = 0;
+    unsigned int moment = maxInterval.start();
+    std::vector<Event>::const_iterator it = events.begin();
+    while (moment <= maxInterval.finish()) {
+        for (; it != events.end() && it->first <= moment; it++) {
+            count += it->second;
+        }
+        if (allows(count)) {
+            if (!inRun) runStart = moment;
+            inRun = true;
+        } else if (inRun) {
+            set.add(SpanInterval(runStart, moment-1, runStart, moment-1));
+            inRun = false;
+        }
+        moment = (it == events.end() || it->first > maxInterval.finish()
+                ? maxInterval.finish() + 1 : it->first);
+    }
+    if (inRun) set.add(SpanInterval(runStart, maxInterval.finish(), runStart, maxInterval.finish()));
+    set.setForceLiquid(forceLiquid);
+    return set;
+}
@@ -0,0 +1,163 @@
+/*
+ * Cardinality.h
+ */
+
+#ifndef CARDINALITY_H_
+#define CARDINALITY_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/void_cast.hpp>
+#include "Atom.h"
+#include "Sentence.h"
+#include "SentenceVisitor.h"
+
+class Domain;
+class Model;
+
+/**
+ * A cardinality constraint over a list of atoms, written ex1(a, b, ...)
+ * ("exactly one of") or at1(a, b, ...) ("at most one of").
+ *
+ * Like a liquid sentence, it is judged at every moment of an interval: it is
+ * true at [i:j] if the number of its atoms true at each point of [i:j] is one
+ * (exactly one) or no more than one (at most one).  ex1(a, b, c) is the same
+ * as [ (a ^ !b ^ !c) v (!a ^ b ^ !c) v (!a ^ !b ^ c) ], but is evaluated with
+ * a single sweep over the atoms' intervals rather than by combining sets for
+ * every one of those disjuncts.
+ */
+class Cardinality : public Sentence {
+public:
+    static const std::size_t TypeCode = 13;
+
+    enum Kind {
+        EXACTLY_ONE,
+        AT_MOST_ONE
+    };
+
+    Cardinality();
+    template <class InputIterator>
+    Cardinality(Kind kind, InputIterator begin, InputIterator end);
+    Cardinality(const Cardinality& c);  // shallow copy
+    virtual ~Cardinality();
+
+    friend void swap(Cardinality& a, Cardinality& b);
+    Cardinality& operator=(Cardinality c);
+
+    Kind kind() const;
+    const std::vector<boost::shared_ptr<Atom> >& atoms() const;
+
+    void setKind(Kind kind);
+    void setAtoms(const std::vector<boost::shared_ptr<Atom> >& atoms);
+
+    /**
+     * Whether count atoms being true at one moment satisfies this constraint.
+     */
+    bool allows(int count) const;
+
+    virtual std::size_t getTypeCode() const;
+    friend std::size_t hash_value(const Cardinality& c);
+    virtual SISet satisfied(const Model& m, const Domain& d, bool forceLiquid) const;
+private:
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version);
+
+    Kind kind_;
+    std::vector<boost::shared_ptr<Atom> > atoms_;
+
+    virtual Sentence* doClone() const;
+    virtual bool doEquals(const Sentence& s) const;
+    virtual void doToString(std::stringstream& str) const;
+    virtual int doPrecedence() const;
+    virtual void visit(SentenceVisitor& v) const;
+    virtual bool doContains(const Sentence& s) const;
+    virtual std::size_t doHashValue() const;
+};
+
+// IMPLEMENTATION
+inline Cardinality::Cardinality() : kind_(EXACTLY_ONE), atoms_() {}
+template <class InputIterator>
+Cardinality::Cardinality(Kind kind, InputIterator begin, InputIterator end)
+    : kind_(kind), atoms_(begin, end) {}
+inline Cardinality::Cardinality(const Cardinality& c) : kind_(c.kind_), atoms_(c.atoms_) {}
+inline Cardinality::~Cardinality() {}
+
+inline void swap(Cardinality& a, Cardinality& b) {
+    using std::swap;
+    swap(a.kind_, b.kind_);
+    swap(a.atoms_, b.atoms_);
+}
+
+inline Cardinality& Cardinality::operator=(Cardinality c) {
+    swap(*this, c);
+    return *this;
+}
+
+inline Cardinality::Kind Cardinality::kind() const { return kind_;}
+inline const std::vector<boost::shared_ptr<Atom> >& Cardinality::atoms() const { return atoms_;}
+inline void Cardinality::setKind(Kind kind) { kind_ = kind;}
+inline void Cardinality::setAtoms(const std::vector<boost::shared_ptr<Atom> >& atoms) { atoms_ = atoms;}
+
+inline bool Cardinality::allows(int count) const {
+    return (kind_ == EXACTLY_ONE ? count == 1 : count <= 1);
+}
+
+inline std::size_t Cardinality::getTypeCode() const { return Cardinality::TypeCode;}
+
+inline std::size_t hash_value(const Cardinality& c) {
+    std::size_t seed = Cardinality::TypeCode;
+    boost::hash_combine(seed, c.kind_);
+    for (std::vector<boost::shared_ptr<Atom> >::const_iterator it = c.atoms_.begin(); it != c.atoms_.end(); it++) {
+        boost::hash_combine(seed, **it);
+    }
+    return seed;
+}
+
+// private members
+inline Sentence* Cardinality::doClone() const { return new Cardinality(*this); }
+
+inline bool Cardinality::doEquals(const Sentence& s) const {
+    const Cardinality *card = dynamic_cast<const Cardinality*>(&s);
+    if (card == NULL || kind_ != card->kind_ || atoms_.size() != card->atoms_.size()) {
+        return false;
+    }
+    for (std::vector<boost::shared_ptr<Atom> >::size_type i = 0; i < atoms_.size(); i++) {
+        if (!(*atoms_[i] == *card->atoms_[i])) return false;
+    }
+    return true;
+}
+
+inline int Cardinality::doPrecedence() const { return 0; };
+inline void Cardinality::visit(SentenceVisitor& v) const {
+    for (std::vector<boost::shared_ptr<Atom> >::const_iterator it = atoms_.begin(); it != atoms_.end(); it++) {
+        (*it)->visit(v);
+    }
+
+    v.accept(*this);
+}
+
+inline bool Cardinality::doContains(const Sentence& s) const {
+    if (*this == s) return true;
+    for (std::vector<boost::shared_ptr<Atom> >::const_iterator it = atoms_.begin(); it != atoms_.end(); it++) {
+        if ((*it)->contains(s)) return true;
+    }
+    return false;
+}
+inline std::size_t Cardinality::doHashValue() const { return hash_value(*this);}
+
+template <class Archive>
+void Cardinality::serialize(Archive& ar, const unsigned int version) {
+    // register that we dont need to call the base class
+    boost::serialization::void_cast_register<Cardinality, Sentence>(
+            static_cast<Cardinality*>(NULL),
+            static_cast<Sentence*>(NULL)
+            );
+    ar & kind_;
+    ar & atoms_;
+}
+
+#endif /* CARDINALITY_H_ */
@@ -5,7 +5,9 @@
  *      Author: joe
  */
 
+#include <algorithm>
 #include "Conjunction.h"
+#include "Negation.h"
 #include "../Domain.h"
 
 
@@ -16,14 +18,59 @@ void Conjunction::visit(SentenceVisitor& v) const {
     v.accept(*this);
 }
 
-const std::set<Interval::INTERVAL_RELATION>& Conjunction::defaultRelations() {
-    static std::set<Interval::INTERVAL_RELATION>* defaults = new std::set<Interval::INTERVAL_RELATION>();
-    if (defaults->empty()) {
+namespace {
+    std::set<Interval::INTERVAL_RELATION>* makeDefaultRelations() {
+        std::set<Interval::INTERVAL_RELATION>* defaults = new std::set<Interval::INTERVAL_RELATION>();
         defaults->insert(Interval::EQUALS);
+        return defaults;
     }
+}
+
+const std::set<Interval::INTERVAL_RELATION>& Conjunction::defaultRelations() {
+    // filled in by the initializer, which only runs once even when called
+    // from several threads
+    static const std::set<Interval::INTERVAL_RELATION>* defaults = makeDefaultRelations();
     return *defaults;
 }
 
+namespace {
+    void collectIntersectionArgs(const Sentence& s, bool forceLiquid, std::vector<const Sentence*>& args) {
+        if (s.getTypeCode() != Conjunction::TypeCode
+                || !static_cast<const Conjunction&>(s).isIntersection(forceLiquid)) {
+            args.push_back(&s);
+            return;
+        }
+        const Conjunction& c = static_cast<const Conjunction&>(s);
+        collectIntersectionArgs(*c.left(), forceLiquid, args);
+        collectIntersectionArgs(*c.right(), forceLiquid, args);
+    }
+}
+
+std::vector<const Sentence*> Conjunction::intersectionArgs(bool forceLiquid) const {
+    std::vector<const Sentence*> args;
+    if (!isIntersection(forceLiquid)) {
+        args.push_back(&*left_);
+        args.push_back(&*right_);
+        return args;
+    }
+    collectIntersectionArgs(*this, forceLiquid, args);
+    return args;
+}
+
+std::vector<const Sentence*> Conjunction::sequenceArgs() const {
+    std::vector<const Sentence*> args;
+    const Conjunction* c = this;
+    args.push_back(&*c->right_);
+    while (c->isSequence() && c->left_->getTypeCode() == Conjunction::TypeCode
+            && static_cast<const Conjunction&>(*c->left_).isSequence()) {
+        c = static_cast<const Conjunction*>(&*c->left_);
+        args.push_back(&*c->right_);
+    }
+    args.push_back(&*c->left_);
+    std::reverse(args.begin(), args.end());
+    return args;
+}
+
 void Conjunction::doToString(std::stringstream& str) const {
     if (left_->precedence() > precedence()) {
         str << "(";
@@ -76,29 +123,28 @@ void Conjunction::doToString(std::stringstream& str) const {
 }
 
 SISet Conjunction::satisfied(const Model& m, const Domain& d, bool forceLiquid) const {
-    SISet leftSat = left_->satisfied(m, d, forceLiquid);
-    SISet rightSat = right_->satisfied(m, d, forceLiquid);
-
-    if (forceLiquid) {
-        leftSat.setForceLiquid(true);
-        rightSat.setForceLiquid(true);
-        // conjunction must be intersection
-        return intersection(leftSat, rightSat);
-    } else {
-        leftSat.setForceLiquid(false);
-        rightSat.setForceLiquid(false);
-    }
-
-    SISet result(false, d.maxInterval());
-    for(SISet::const_iterator lIt = leftSat.begin(); lIt != leftSat.end(); lIt++ ) {
-        for (SISet::const_iterator rIt = rightSat.begin(); rIt != rightSat.end(); rIt++) {
-            for(std::set<Interval::INTERVAL_RELATION>::const_iterator relIt = rels_.begin();
-                    relIt != rels_.end();
-                    relIt++) {
-                result.add(composedOf(*lIt, *rIt, *relIt, d.maxSpanInterval()));
+    // evaluate whole intersections at once rather than one pair at a time;
+    // ";" chains are composed a pair at a time, since an enclosing relation
+    // or diamond may compose their span intervals, and sequenceOf()'s merged
+    // ones would give it different intervals
+    if (isIntersection(forceLiquid)) {
+        // negated operands are subtracted rather than complemented
+        std::vector<const Sentence*> args = intersectionArgs(forceLiquid);
+        std::vector<SISet> parts, without;
+        for (std::vector<const Sentence*>::const_iterator it = args.begin(); it != args.end(); it++) {
+            if ((*it)->getTypeCode() == Negation::TypeCode) {
+                without.push_back(static_cast<const Negation&>(**it).sentence()->satisfied(m, d, forceLiquid));
+                without.back().setForceLiquid(forceLiquid);
+            } else {
+                parts.push_back((*it)->satisfied(m, d, forceLiquid));
+                parts.back().setForceLiquid(forceLiquid);
             }
         }
+        return intersectionOf(parts, without, forceLiquid, d.maxSpanInterval());
     }
-
-    return result;
+    SISet leftSat = left_->satisfied(m, d, false);
+    SISet rightSat = right_->satisfied(m, d, false);
+    leftSat.setForceLiquid(false);
+    rightSat.setForceLiquid(false);
+    return composedOf(leftSat, rightSat, rels_, d.maxSpanInterval());
 }
@@ -2,6 +2,7 @@
 #define CONJUNCTION_H
 
 #include <set>
+#include <vector>
 #include <utility>
 #include <boost/shared_ptr.hpp>
 #include <boost/functional/hash.hpp>
@@ -62,6 +63,41 @@ public:
     void setRelations(T begin, T end);
     void setTQConstraints(const std::pair<TQConstraints, TQConstraints>& tq);
 
+    /**
+     * Whether this is a sequence "a ; b", i.e. its only relation is MEETS.
+     */
+    bool isSequence() const;
+
+    /**
+     * Get the operands of the chain of sequences down the left side of this
+     * conjunction, in order; for ((a ; b) ; c) ; d this is a, b, c, d.  The
+     * parser nests chains to the left.  Sequences on the right are kept as
+     * operands, since composing under MEETS is only approximately
+     * associative.
+     *
+     * @return  the operands, or just left() and right() if this isn't a
+     *   sequence
+     */
+    std::vector<const Sentence*> sequenceArgs() const;
+
+    /**
+     * Whether this conjunction intersects its operands rather than composing
+     * them: always when evaluated as liquid, otherwise when its only
+     * relation is EQUALS.
+     *
+     * @param forceLiquid  whether the conjunction is evaluated as liquid
+     */
+    bool isIntersection(bool forceLiquid) const;
+
+    /**
+     * Get the operands of the tree of intersecting conjunctions rooted here
+     * (see isIntersection()), from left to right; for (a ^ b) ^ (c ^ d)
+     * this is a, b, c, d.
+     *
+     * @param forceLiquid  whether the conjunction is evaluated as liquid
+     */
+    std::vector<const Sentence*> intersectionArgs(bool forceLiquid) const;
+
     virtual void visit(SentenceVisitor& v) const;
 
     static const std::set<Interval::INTERVAL_RELATION>& defaultRelations();
@@ -166,6 +202,12 @@ inline void Conjunction::setRelations(T begin, T end) {
 inline void Conjunction::setTQConstraints(const std::pair<TQConstraints, TQConstraints>& tq) {
     tqconstraints_ = tq;
 }
+inline bool Conjunction::isSequence() const {
+    return rels_.size() == 1 && *rels_.begin() == Interval::MEETS;
+}
+inline bool Conjunction::isIntersection(bool forceLiquid) const {
+    return forceLiquid || (rels_.size() == 1 && *rels_.begin() == Interval::EQUALS);
+}
 // private members
 inline Sentence* Conjunction::doClone() const { return new Conjunction(*this); }
 inline std::size_t Conjunction::doHashValue() const {return hash_value(*this);}
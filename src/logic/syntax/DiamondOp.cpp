@@ -1,9 +1,9 @@
 #include "DiamondOp.h"
 #include "../Domain.h"
 
-const std::set<Interval::INTERVAL_RELATION>& DiamondOp::defaultRelations() {
-    static std::set<Interval::INTERVAL_RELATION>* defaults = new std::set<Interval::INTERVAL_RELATION>();
-    if (defaults->size() == 0) {
+namespace {
+    std::set<Interval::INTERVAL_RELATION>* makeDefaultRelations() {
+        std::set<Interval::INTERVAL_RELATION>* defaults = new std::set<Interval::INTERVAL_RELATION>();
         defaults->insert(Interval::STARTS);
         defaults->insert(Interval::STARTSI);
         defaults->insert(Interval::DURING);
@@ -12,7 +12,14 @@ const std::set<Interval::INTERVAL_RELATION>& DiamondOp::defaultRelations() {
         defaults->insert(Interval::FINISHESI);
         defaults->insert(Interval::OVERLAPS);
         defaults->insert(Interval::OVERLAPSI);
+        return defaults;
     }
+}
+
+const std::set<Interval::INTERVAL_RELATION>& DiamondOp::defaultRelations() {
+    // filled in by the initializer, which only runs once even when called
+    // from several threads
+    static const std::set<Interval::INTERVAL_RELATION>* defaults = makeDefaultRelations();
     return *defaults;
 }
 
@@ -137,7 +137,9 @@ inline bool DiamondOp::doEquals(const Sentence& s) const {
     if (dia == NULL) {
         return false;
     }
-    return *s_ == *(dia->s_);
+    return (*s_ == *(dia->s_)
+            && rels_ == dia->rels_
+            && tqconstraints_ == dia->tqconstraints_);
 }
 inline int DiamondOp::doPrecedence() const { return 2; };
 inline bool DiamondOp::doContains(const Sentence& s) const {
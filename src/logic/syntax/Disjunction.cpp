@@ -5,6 +5,25 @@
  *      Author: joe
  */
 #include "Disjunction.h"
+#include "../Domain.h"
+
+namespace {
+    void collectUnionArgs(const Sentence& s, std::vector<const Sentence*>& args) {
+        if (s.getTypeCode() != Disjunction::TypeCode) {
+            args.push_back(&s);
+            return;
+        }
+        const Disjunction& dis = static_cast<const Disjunction&>(s);
+        collectUnionArgs(*dis.left(), args);
+        collectUnionArgs(*dis.right(), args);
+    }
+}
+
+std::vector<const Sentence*> Disjunction::unionArgs() const {
+    std::vector<const Sentence*> args;
+    collectUnionArgs(*this, args);
+    return args;
+}
 
 void Disjunction::doToString(std::stringstream& str) const {
     if (left_->precedence() > precedence()) {
@@ -25,15 +44,12 @@ void Disjunction::doToString(std::stringstream& str) const {
 };
 
 SISet Disjunction::satisfied(const Model& m, const Domain& d, bool forceLiquid) const {
-    SISet leftSat = left_->satisfied(m, d, forceLiquid);
-    SISet rightSat = right_->satisfied(m, d, forceLiquid);
-    if (!forceLiquid) {
-        leftSat.setForceLiquid(false);
-        rightSat.setForceLiquid(false);
-    } else {
-        leftSat.setForceLiquid(true);
-        rightSat.setForceLiquid(true);
+    // union every operand of the tree at once rather than one pair at a time
+    std::vector<const Sentence*> args = unionArgs();
+    std::vector<SISet> parts(args.size());
+    for (std::size_t i = 0; i < args.size(); i++) {
+        parts[i] = args[i]->satisfied(m, d, forceLiquid);
+        parts[i].setForceLiquid(forceLiquid);
     }
-    leftSat.add(rightSat);
-    return leftSat;
+    return unionOf(parts, forceLiquid, d.maxInterval());
 }
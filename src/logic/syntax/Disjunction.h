@@ -1,6 +1,7 @@
 #ifndef DISJUNCTION_H
 #define DISJUNCTION_H
 
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/export.hpp>
@@ -31,6 +32,12 @@ public:
     void setLeft(boost::shared_ptr<Sentence> s);
     void setRight(boost::shared_ptr<Sentence> s);
 
+    /**
+     * Get the operands of the tree of disjunctions rooted here, from left to
+     * right; for (a v b) v (c v d) this is a, b, c, d.
+     */
+    std::vector<const Sentence*> unionArgs() const;
+
     virtual std::size_t getTypeCode() const;
     friend std::size_t hash_value(const Disjunction& d);
     virtual SISet satisfied(const Model& m, const Domain& d, bool forceLiquid) const;
@@ -25,6 +25,8 @@ std::string ELSentence::toString() const {
 };
 
 SISet ELSentence::dSatisfied(const Model& m, const Domain& d) const {
+    // callers with the formula's domain should use Domain::dSatisfied(),
+    // which evaluates quantified formulas only on their quantification
     if (isQuantified()) return s_->dSatisfied(m, d, *quantification_);
     else return s_->dSatisfied(m, d);
 }
@@ -35,6 +37,8 @@ SISet ELSentence::dNotSatisfied(const Model& m, const Domain& d) const {
 }
 
 bool ELSentence::fullySatisfied(const Model& m, const Domain& d) const {
+    // callers with the formula's domain should use
+    // Domain::isFullySatisfied(formulaId, ...), which doesn't recompile it
     SISet satisfiedAt = dSatisfied(m, d);
     SISet toSatisfyAt(false, d.maxInterval());
     if (quantification_ != 0) {
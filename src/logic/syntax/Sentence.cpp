@@ -28,32 +28,10 @@ std::string TQConstraints::toString() const {
 }
 
 bool isDisjunctionOfPELCNFLiterals(const Sentence& s) {
-    if (s.getTypeCode() != Disjunction::TypeCode) {
-        LOG(LOG_WARN) << "sentence: \"" << s.toString() << "\". type is not Disjunction";
-        return false;
-    }
+    if (s.getTypeCode() != Disjunction::TypeCode) return false;
     const Disjunction& dis = static_cast<const Disjunction&>(s);
-    
-    if (!isPELCNFLiteral(*dis.left())){
-        LOG(LOG_WARN) << "left sentence: \"" << dis.left()->toString() << "\". is not PELCNFLiteral";
-    }
-    if (!isDisjunctionOfPELCNFLiterals(*dis.left())){
-        LOG(LOG_WARN) << "left sentence: \"" << dis.left()->toString() << "\". is not DisjunctionOfPELCNFLiterals";
-    }
-    if (!isPELCNFLiteral(*dis.right())){
-        LOG(LOG_WARN) << "right sentence: \"" << dis.right()->toString() << "\". is not PELCNFLiteral";
-    }
-    if (!isDisjunctionOfPELCNFLiterals(*dis.right())){
-        LOG(LOG_WARN) << "right sentence: \"" << dis.right()->toString() << "\". is not DisjunctionOfPELCNFLiterals";
-    }
-
-    if ((isPELCNFLiteral(*dis.left()) || isDisjunctionOfPELCNFLiterals(*dis.left()))
-            && (isPELCNFLiteral(*dis.right()) || isDisjunctionOfPELCNFLiterals(*dis.right()))) {
-        LOG(LOG_WARN) << "sentence: \"" << s.toString() << "\". is DisjunctionOfPELCNFLiterals";
-        return true;
-    }
-    LOG(LOG_WARN) << "sentence: \"" << s.toString() << "\". is not DisjunctionOfPELCNFLiterals";
-    return false;
+    return (isPELCNFLiteral(*dis.left()) || isDisjunctionOfPELCNFLiterals(*dis.left()))
+            && (isPELCNFLiteral(*dis.right()) || isDisjunctionOfPELCNFLiterals(*dis.right()));
 }
 
 bool isPELCNFLiteral(const Sentence& sentence) {
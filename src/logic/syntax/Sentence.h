@@ -203,8 +203,13 @@ inline SISet Sentence::dNotSatisfied(const Model& m, const Domain& d) const {
 }
 
 inline SISet Sentence::dNotSatisfied(const Model& m, const Domain& d, const SISet& where) const {
-    SISet set = satisfied(m, d, false);
-    set = intersection(set.compliment(), where);
+    // take out what's satisfied rather than intersecting with the compliment
+    SISet sat = satisfied(m, d, false);
+    SISet set = where;
+    set.setForceLiquid(false);
+    for (SISet::const_iterator it = sat.begin(); it != sat.end() && set.begin() != set.end(); it++) {
+        set.subtract(*it);
+    }
     set.makeDisjoint();
     return set;
 }
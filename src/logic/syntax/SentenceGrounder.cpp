@@ -0,0 +1,167 @@
+/*
+ * SentenceGrounder.cpp
+ */
+
+#include <algorithm>
+#include "SentenceGrounder.h"
+#include "Atom.h"
+#include "Cardinality.h"
+#include "Conjunction.h"
+#include "Constant.h"
+#include "DiamondOp.h"
+#include "Disjunction.h"
+#include "LiquidOp.h"
+#include "Negation.h"
+#include "SentenceVisitor.h"
+
+namespace {
+    // collects the typed variables of a sentence in the order they appear
+    struct TypedVariableCollector : public SentenceVisitor {
+        TypedVariableCollector(const SentenceGrounder::TypeMap& t) : types(t), variables() {}
+
+        virtual void accept(const Sentence& s) {
+            if (s.getTypeCode() != Atom::TypeCode) return;
+            const Atom& a = static_cast<const Atom&>(s);
+            for (Atom::term_const_iterator it = a.term_begin(); it != a.term_end(); it++) {
+                const Variable* var = dynamic_cast<const Variable*>(&*it);
+                if (var != NULL && types.count(var->getName()) != 0
+                        && std::find(variables.begin(), variables.end(), *var) == variables.end()) {
+                    variables.push_back(*var);
+                }
+            }
+        }
+
+        const SentenceGrounder::TypeMap& types;
+        std::vector<Variable> variables;
+    };
+
+    boost::shared_ptr<Atom> substituteAtom(const boost::shared_ptr<Atom>& a,
+            const std::map<Variable, std::string>& binding) {
+        bool changed = false;
+        for (Atom::term_const_iterator it = a->term_begin(); !changed && it != a->term_end(); it++) {
+            const Variable* var = dynamic_cast<const Variable*>(&*it);
+            changed = (var != NULL && binding.count(*var) != 0);
+        }
+        if (!changed) return a;
+
+        boost::shared_ptr<Atom> copy(new Atom(a->name()));
+        for (Atom::term_const_iterator it = a->term_begin(); it != a->term_end(); it++) {
+            const Variable* var = dynamic_cast<const Variable*>(&*it);
+            std::map<Variable, std::string>::const_iterator bound =
+                    (var == NULL ? binding.end() : binding.find(*var));
+            if (bound != binding.end()) {
+                copy->push_back(Constant(bound->second));
+            } else {
+                copy->push_back(*it);
+            }
+        }
+        return copy;
+    }
+}
+
+SentenceGrounder::SentenceGrounder(const ELSentence& formula, const TypeMap& types)
+    : formula_(formula), variables_(), values_(), choice_(), done_(false) {
+    TypedVariableCollector collector(types);
+    formula.sentence()->visit(collector);
+    variables_ = collector.variables;
+    for (std::vector<Variable>::const_iterator it = variables_.begin(); it != variables_.end(); it++) {
+        const std::set<std::string>& constants = types.find(it->getName())->second;
+        values_.push_back(std::vector<std::string>(constants.begin(), constants.end()));
+        if (constants.empty()) done_ = true;    // nothing to ground it with
+    }
+    choice_.resize(variables_.size(), 0);
+}
+
+std::size_t SentenceGrounder::size() const {
+    std::size_t count = 1;
+    for (std::vector<std::vector<std::string> >::const_iterator it = values_.begin(); it != values_.end(); it++) {
+        count *= it->size();
+    }
+    return count;
+}
+
+bool SentenceGrounder::next(ELSentence& ground) {
+    if (done_) return false;
+    std::map<Variable, std::string> binding;
+    for (std::size_t i = 0; i < variables_.size(); i++) {
+        binding.insert(std::make_pair(variables_[i], values_[i][choice_[i]]));
+    }
+    ground = formula_;
+    ground.setSentence(substitute(formula_.sentence(), binding));
+
+    // advance to the next choice, the last variable fastest
+    std::size_t i = variables_.size();
+    while (i > 0 && ++choice_[i-1] == values_[i-1].size()) {
+        choice_[i-1] = 0;
+        i--;
+    }
+    if (i == 0) done_ = true;
+    return true;
+}
+
+boost::shared_ptr<Sentence> substitute(const boost::shared_ptr<Sentence>& s,
+        const std::map<Variable, std::string>& binding) {
+    switch (s->getTypeCode()) {
+    case Atom::TypeCode:
+        return substituteAtom(boost::static_pointer_cast<Atom>(s), binding);
+    case Negation::TypeCode: {
+        Negation& neg = static_cast<Negation&>(*s);
+        boost::shared_ptr<Sentence> child = substitute(neg.sentence(), binding);
+        if (child == neg.sentence()) return s;
+        boost::shared_ptr<Negation> copy(new Negation(neg));
+        copy->setSentence(child);
+        return copy;
+    }
+    case Disjunction::TypeCode: {
+        Disjunction& dis = static_cast<Disjunction&>(*s);
+        boost::shared_ptr<Sentence> left = substitute(dis.left(), binding);
+        boost::shared_ptr<Sentence> right = substitute(dis.right(), binding);
+        if (left == dis.left() && right == dis.right()) return s;
+        boost::shared_ptr<Disjunction> copy(new Disjunction(dis));
+        copy->setLeft(left);
+        copy->setRight(right);
+        return copy;
+    }
+    case Conjunction::TypeCode: {
+        Conjunction& con = static_cast<Conjunction&>(*s);
+        boost::shared_ptr<Sentence> left = substitute(con.left(), binding);
+        boost::shared_ptr<Sentence> right = substitute(con.right(), binding);
+        if (left == con.left() && right == con.right()) return s;
+        boost::shared_ptr<Conjunction> copy(new Conjunction(con));
+        copy->setLeft(left);
+        copy->setRight(right);
+        return copy;
+    }
+    case DiamondOp::TypeCode: {
+        DiamondOp& dia = static_cast<DiamondOp&>(*s);
+        boost::shared_ptr<Sentence> child = substitute(dia.sentence(), binding);
+        if (child == dia.sentence()) return s;
+        boost::shared_ptr<DiamondOp> copy(new DiamondOp(dia));
+        copy->setSentence(child);
+        return copy;
+    }
+    case LiquidOp::TypeCode: {
+        LiquidOp& liq = static_cast<LiquidOp&>(*s);
+        boost::shared_ptr<Sentence> child = substitute(liq.sentence(), binding);
+        if (child == liq.sentence()) return s;
+        boost::shared_ptr<LiquidOp> copy(new LiquidOp(liq));
+        copy->setSentence(child);
+        return copy;
+    }
+    case Cardinality::TypeCode: {
+        const Cardinality& card = static_cast<const Cardinality&>(*s);
+        std::vector<boost::shared_ptr<Atom> > atoms;
+        bool changed = false;
+        for (std::vector<boost::shared_ptr<Atom> >::const_iterator it = card.atoms().begin(); it != card.atoms().end(); it++) {
+            atoms.push_back(substituteAtom(*it, binding));
+            changed = changed || atoms.back() != *it;
+        }
+        if (!changed) return s;
+        boost::shared_ptr<Cardinality> copy(new Cardinality(card));
+        copy->setAtoms(atoms);
+        return copy;
+    }
+    default:
+        return s;   // no variables below
+    }
+}
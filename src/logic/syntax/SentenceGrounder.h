@@ -0,0 +1,81 @@
+/*
+ * SentenceGrounder.h
+ */
+
+#ifndef SENTENCEGROUNDER_H_
+#define SENTENCEGROUNDER_H_
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "ELSentence.h"
+#include "Sentence.h"
+#include "Variable.h"
+
+/**
+ * Grounds a formula with typed variables, such as ?player:1 or ?player:*,
+ * over the constants of their types.
+ *
+ * The formula is parsed only once; every grounding is made by substituting
+ * constants into that tree, so the parts of it without variables are shared
+ * by all the ground formulas rather than copied.  Groundings are produced one
+ * at a time by next(), with the first variable of the formula changing
+ * slowest, so the whole set never has to be held at once.
+ *
+ * A variable is typed if its name is one of the given types; any other
+ * variables are left in the ground formulas as they are.
+ */
+class SentenceGrounder {
+public:
+    typedef std::map<std::string, std::set<std::string> > TypeMap;
+
+    /**
+     * Prepare to ground a formula.
+     *
+     * @param formula  the formula to ground
+     * @param types  the constants of each type, by type name
+     */
+    SentenceGrounder(const ELSentence& formula, const TypeMap& types);
+
+    /**
+     * Get the typed variables of the formula, in the order they first appear.
+     */
+    const std::vector<Variable>& variables() const;
+
+    /**
+     * Get the number of groundings of the formula.
+     */
+    std::size_t size() const;
+
+    /**
+     * Get the next grounding of the formula.
+     *
+     * @param ground  set to the next ground formula
+     * @return  false if every grounding has already been returned
+     */
+    bool next(ELSentence& ground);
+private:
+    ELSentence formula_;
+    std::vector<Variable> variables_;
+    std::vector<std::vector<std::string> > values_;
+    std::vector<std::size_t> choice_;
+    bool done_;
+};
+
+/**
+ * Replace variables in a sentence with constants.  Nodes are only copied when
+ * something below them changed, so s is never modified.
+ *
+ * @param s  the sentence to substitute into
+ * @param binding  the name of the constant to replace each variable with
+ */
+boost::shared_ptr<Sentence> substitute(const boost::shared_ptr<Sentence>& s,
+        const std::map<Variable, std::string>& binding);
+
+// IMPLEMENTATION
+inline const std::vector<Variable>& SentenceGrounder::variables() const { return variables_;}
+
+#endif /* SENTENCEGROUNDER_H_ */
@@ -0,0 +1,98 @@
+/*
+ * SentenceInterner.cpp
+ */
+
+#include "SentenceInterner.h"
+#include "Cardinality.h"
+#include "Conjunction.h"
+#include "DiamondOp.h"
+#include "Disjunction.h"
+#include "LiquidOp.h"
+#include "Negation.h"
+
+boost::shared_ptr<Sentence> SentenceInterner::intern(const boost::shared_ptr<Sentence>& s) {
+    if (!s) return s;
+    // intern the children first, copying this node only if one changed
+    boost::shared_ptr<Sentence> node = s;
+    switch (s->getTypeCode()) {
+    case Negation::TypeCode: {
+        Negation& neg = static_cast<Negation&>(*s);
+        boost::shared_ptr<Sentence> child = intern(neg.sentence());
+        if (child != neg.sentence()) {
+            boost::shared_ptr<Negation> copy(new Negation(neg));
+            copy->setSentence(child);
+            node = copy;
+        }
+        break;
+    }
+    case Conjunction::TypeCode: {
+        Conjunction& con = static_cast<Conjunction&>(*s);
+        boost::shared_ptr<Sentence> left = intern(con.left());
+        boost::shared_ptr<Sentence> right = intern(con.right());
+        if (left != con.left() || right != con.right()) {
+            boost::shared_ptr<Conjunction> copy(new Conjunction(con));
+            copy->setLeft(left);
+            copy->setRight(right);
+            node = copy;
+        }
+        break;
+    }
+    case Disjunction::TypeCode: {
+        Disjunction& dis = static_cast<Disjunction&>(*s);
+        boost::shared_ptr<Sentence> left = intern(dis.left());
+        boost::shared_ptr<Sentence> right = intern(dis.right());
+        if (left != dis.left() || right != dis.right()) {
+            boost::shared_ptr<Disjunction> copy(new Disjunction(dis));
+            copy->setLeft(left);
+            copy->setRight(right);
+            node = copy;
+        }
+        break;
+    }
+    case DiamondOp::TypeCode: {
+        DiamondOp& dia = static_cast<DiamondOp&>(*s);
+        boost::shared_ptr<Sentence> child = intern(dia.sentence());
+        if (child != dia.sentence()) {
+            boost::shared_ptr<DiamondOp> copy(new DiamondOp(dia));
+            copy->setSentence(child);
+            node = copy;
+        }
+        break;
+    }
+    case LiquidOp::TypeCode: {
+        LiquidOp& liq = static_cast<LiquidOp&>(*s);
+        boost::shared_ptr<Sentence> child = intern(liq.sentence());
+        if (child != liq.sentence()) {
+            boost::shared_ptr<LiquidOp> copy(new LiquidOp(liq));
+            copy->setSentence(child);
+            node = copy;
+        }
+        break;
+    }
+    case Cardinality::TypeCode: {
+        Cardinality& card = static_cast<Cardinality&>(*s);
+        std::vector<boost::shared_ptr<Atom> > atoms;
+        bool changed = false;
+        for (std::vector<boost::shared_ptr<Atom> >::const_iterator it = card.atoms().begin(); it != card.atoms().end(); it++) {
+            atoms.push_back(boost::static_pointer_cast<Atom>(intern(*it)));
+            changed = changed || atoms.back() != *it;
+        }
+        if (changed) {
+            boost::shared_ptr<Cardinality> copy(new Cardinality(card));
+            copy->setAtoms(atoms);
+            node = copy;
+        }
+        break;
+    }
+    default:
+        break;  // leaves
+    }
+
+    NodeSet::const_iterator found = nodes_.find(node);
+    if (found != nodes_.end()) return *found;
+    // the caller still owns s and may change it later, so the table gets its
+    // own copy (shallow, as its children are already interned)
+    if (node == s) node.reset(s->clone());
+    nodes_.insert(node);
+    return node;
+}
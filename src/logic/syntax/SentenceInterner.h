@@ -0,0 +1,67 @@
+/*
+ * SentenceInterner.h
+ */
+
+#ifndef SENTENCEINTERNER_H_
+#define SENTENCEINTERNER_H_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_set.hpp>
+#include "Sentence.h"
+
+/**
+ * Hash-conses sentences, so that structurally equal subformulas are
+ * represented by a single shared node.
+ *
+ * intern() rebuilds a sentence bottom up, replacing every subformula with the
+ * equal node already in the table (or adding it if there's none).  Nodes are
+ * only copied when one of their children was replaced, so interning an
+ * already interned sentence returns it unchanged.  Interning all the formulas
+ * of a domain through one interner turns them into a DAG, where a repeated
+ * subformula like !Spike(backleft) is a single node; the evaluation cache
+ * keys on nodes, so it is then computed once per model state.
+ *
+ * The table only holds nodes it made itself: a node of the caller's is copied
+ * when it is added, so the caller changing its sentence afterwards can't
+ * change an interned one.  Interned nodes are shared between sentences (and
+ * between copies of a Domain) and must not be modified.
+ */
+class SentenceInterner {
+public:
+    SentenceInterner();
+
+    /**
+     * Get the interned version of a sentence.
+     *
+     * @param s  the sentence to intern
+     * @return  a sentence equal to s whose subformulas are all shared nodes;
+     *          this is s itself only if s was already interned
+     */
+    boost::shared_ptr<Sentence> intern(const boost::shared_ptr<Sentence>& s);
+
+    /**
+     * Get the number of distinct nodes interned.
+     */
+    std::size_t size() const;
+
+    void clear();
+private:
+    struct NodeHash {
+        std::size_t operator()(const boost::shared_ptr<Sentence>& s) const { return hash_value(*s);}
+    };
+    struct NodeEquals {
+        bool operator()(const boost::shared_ptr<Sentence>& a, const boost::shared_ptr<Sentence>& b) const {
+            return a == b || *a == *b;
+        }
+    };
+    typedef boost::unordered_set<boost::shared_ptr<Sentence>, NodeHash, NodeEquals> NodeSet;
+
+    NodeSet nodes_;
+};
+
+// IMPLEMENTATION
+inline SentenceInterner::SentenceInterner() : nodes_() {}
+inline std::size_t SentenceInterner::size() const { return nodes_.size();}
+inline void SentenceInterner::clear() { nodes_.clear();}
+
+#endif /* SENTENCEINTERNER_H_ */
@@ -0,0 +1,792 @@
+/*
+ * SentenceProgram.cpp
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include "SentenceProgram.h"
+#include "Atom.h"
+#include "BoolLit.h"
+#include "Conjunction.h"
+#include "DiamondOp.h"
+#include "Disjunction.h"
+#include "LiquidOp.h"
+#include "Negation.h"
+#include "../Domain.h"
+#include "../Model.h"
+#include "../Move.h"
+
+namespace {
+    // whether a set has an interval in it, without making it disjoint
+    bool hasInterval(const SISet& s) {
+        for (SISet::const_iterator it = s.begin(); it != s.end(); it++) {
+            if (it->size() > 0) return true;
+        }
+        return false;
+    }
+
+    // whether a and b have an interval in common, stopping at the first
+    bool meets(const SISet& a, const SISet& b) {
+        for (SISet::const_iterator aIt = a.begin(); aIt != a.end(); aIt++) {
+            for (SISet::const_iterator bIt = b.begin(); bIt != b.end(); bIt++) {
+                boost::optional<SpanInterval> common = intersection(*aIt, *bIt);
+                if (common && common->size() > 0) return true;
+            }
+        }
+        return false;
+    }
+}
+
+SentenceProgram::SentenceProgram(boost::shared_ptr<const Sentence> s)
+    : s_(s), program_(), atoms_(), hasDelta_(false) {
+    if (!s_) throw std::invalid_argument("SentenceProgram::SentenceProgram(): given a null sentence");
+    compile(*s_, false, false);
+    hasDelta_ = true;
+    for (std::vector<Instruction>::const_iterator it = program_.begin(); it != program_.end(); it++) {
+        if (!restrictable(*it)) hasDelta_ = false;
+    }
+}
+
+std::size_t SentenceProgram::compile(const Sentence& s, bool forceLiquid, bool composed) {
+    Instruction instr;
+    instr.op = SENTENCE;
+    instr.forceLiquid = forceLiquid;
+    instr.composed = composed;
+    instr.left = 0;
+    instr.right = 0;
+    instr.node = &s;
+    instr.first = program_.size();
+    instr.cacheable = false;
+
+    switch (s.getTypeCode()) {
+    case Atom::TypeCode: {
+        // ungrounded atoms are left to Atom::satisfied(), which reports them
+        const Atom& a = static_cast<const Atom&>(s);
+        if (!a.isGrounded()) break;
+        instr.op = ATOM;
+        std::size_t pos = 0;
+        while (pos < atoms_.size() && *atoms_[pos] != a) pos++;
+        if (pos == atoms_.size()) atoms_.push_back(&a);
+        instr.atoms.push_back(pos);
+        break;
+    }
+    case BoolLit::TypeCode:
+        instr.op = BOOLLIT;
+        break;
+    case Negation::TypeCode:
+        instr.op = NEGATION;
+        instr.left = compile(*static_cast<const Negation&>(s).sentence(), forceLiquid, composed);
+        break;
+    case Conjunction::TypeCode: {
+        const Conjunction& c = static_cast<const Conjunction&>(s);
+        std::vector<const Sentence*> args;
+        if (c.isIntersection(forceLiquid)) {
+            instr.op = INTERSECTION;
+            args = c.intersectionArgs(forceLiquid);
+        } else if (c.isSequence() && !composed) {
+            // sequenceOf() merges span intervals, which only gives the same
+            // intervals when nothing composes its result any further
+            instr.op = SEQUENCE;
+            args = c.sequenceArgs();
+        } else {
+            instr.op = CONJUNCTION;
+            instr.left = compile(*c.left(), false, true);
+            instr.right = compile(*c.right(), false, true);
+            break;
+        }
+        for (std::vector<const Sentence*>::const_iterator it = args.begin(); it != args.end(); it++) {
+            if (instr.op == INTERSECTION && (*it)->getTypeCode() == Negation::TypeCode) {
+                // subtracted from the rest rather than complemented
+                const Negation& neg = static_cast<const Negation&>(**it);
+                instr.without.push_back(compile(*neg.sentence(), forceLiquid, composed));
+            } else {
+                instr.args.push_back(compile(**it, forceLiquid, composed || instr.op == SEQUENCE));
+            }
+        }
+        break;
+    }
+    case Disjunction::TypeCode: {
+        instr.op = DISJUNCTION;
+        std::vector<const Sentence*> args = static_cast<const Disjunction&>(s).unionArgs();
+        for (std::vector<const Sentence*>::const_iterator it = args.begin(); it != args.end(); it++) {
+            instr.args.push_back(compile(**it, forceLiquid, composed));
+        }
+        break;
+    }
+    case DiamondOp::TypeCode:
+        instr.op = DIAMOND;
+        instr.left = compile(*static_cast<const DiamondOp&>(s).sentence(), false, true);
+        break;
+    case LiquidOp::TypeCode:
+        instr.op = LIQUID;
+        instr.left = compile(*static_cast<const LiquidOp&>(s).sentence(), true, composed);
+        break;
+    default:
+        break;
+    }
+
+    // a subtree can be cached when every node in it has an instruction
+    switch (instr.op) {
+    case ATOM:
+    case BOOLLIT:
+        break;  // leaves are cheaper to evaluate than to look up
+    case NEGATION:
+    case DIAMOND:
+    case LIQUID:
+        instr.cacheable = selfContained(instr.left);
+        instr.atoms = program_[instr.left].atoms;
+        break;
+    case CONJUNCTION: {
+        const Instruction& l = program_[instr.left];
+        const Instruction& r = program_[instr.right];
+        instr.cacheable = selfContained(instr.left) && selfContained(instr.right);
+        std::set_union(l.atoms.begin(), l.atoms.end(), r.atoms.begin(), r.atoms.end(),
+                std::back_inserter(instr.atoms));
+        break;
+    }
+    case INTERSECTION:
+    case SEQUENCE:
+    case DISJUNCTION: {
+        instr.cacheable = true;
+        std::vector<std::size_t> operands(instr.args);
+        operands.insert(operands.end(), instr.without.begin(), instr.without.end());
+        for (std::vector<std::size_t>::const_iterator it = operands.begin(); it != operands.end(); it++) {
+            const Instruction& arg = program_[*it];
+            instr.cacheable = instr.cacheable && selfContained(*it);
+            std::vector<std::size_t> atoms;
+            std::set_union(instr.atoms.begin(), instr.atoms.end(), arg.atoms.begin(), arg.atoms.end(),
+                    std::back_inserter(atoms));
+            instr.atoms.swap(atoms);
+        }
+        break;
+    }
+    case SENTENCE:
+        break;
+    }
+
+    program_.push_back(instr);
+    return program_.size()-1;
+}
+
+bool SentenceProgram::restrictable(const Instruction& instr) {
+    switch (instr.op) {
+    case ATOM:
+    case BOOLLIT:
+    case NEGATION:
+    case INTERSECTION:
+    case DISJUNCTION:
+    case LIQUID:
+        return true;
+    case CONJUNCTION:
+    case SEQUENCE:
+        return false;
+    case DIAMOND: {
+        const std::set<Interval::INTERVAL_RELATION>& rels
+            = static_cast<const DiamondOp&>(*instr.node).relations();
+        for (std::set<Interval::INTERVAL_RELATION>::const_iterator it = rels.begin(); it != rels.end(); it++) {
+            switch (*it) {
+            case Interval::EQUALS:
+            case Interval::LESSTHAN:
+            case Interval::GREATERTHAN:
+            case Interval::MEETS:
+            case Interval::MEETSI:
+            case Interval::STARTSI:
+            case Interval::DURINGI:
+            case Interval::FINISHESI:
+                break;
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+    case SENTENCE:
+        return false;
+    }
+    return false;
+}
+
+bool SentenceProgram::selfContained(std::size_t i) const {
+    const Instruction& instr = program_[i];
+    return instr.op == ATOM || instr.op == BOOLLIT || instr.cacheable;
+}
+
+SISet SentenceProgram::satisfied(const Model& m, const Domain& d, Registers& regs) const {
+    if (program_.empty()) throw std::logic_error("SentenceProgram::satisfied(): program is empty");
+    evaluate(m, d, regs, 0, program_.size()-1);
+    SISet result;
+    result.swap(regs[program_.size()-1]);
+    return result;
+}
+
+SISet SentenceProgram::satisfied(const Model& m, const Domain& d, Registers& regs, Cache& cache) const {
+    if (program_.empty()) throw std::logic_error("SentenceProgram::satisfied(): program is empty");
+    evaluate(m, d, regs, &cache, program_.size()-1);
+    SISet result;
+    result.swap(regs[program_.size()-1]);
+    return result;
+}
+
+SentenceProgram::Count SentenceProgram::count(const Model& m,
+        const Domain& d,
+        const SISet* where,
+        Registers& regs,
+        Cache* cache) const {
+    if (program_.empty()) throw std::logic_error("SentenceProgram::count(): program is empty");
+    Count count;
+    count.total = (where ? where->size() : d.maxSpanInterval().size());
+    if (where && cache == NULL && hasDelta_) {
+        // only evaluate the part of the timeline where is on
+        count.satisfied = dSatisfied(m, d, *where, regs).disjointSize();
+        return count;
+    }
+
+    bool negated;
+    std::size_t root = countedRoot(negated);
+    const Instruction& instr = program_[root];
+    evaluate(m, d, regs, cache, (instr.op == LIQUID && where == NULL ? instr.left : root));
+    count.satisfied = countValue(d, where, regs, root);
+    if (negated) count.satisfied = count.total - count.satisfied;
+    return count;
+}
+
+std::size_t SentenceProgram::countedRoot(bool& negated) const {
+    // a negation is true wherever its child isn't, so count the child
+    std::size_t root = program_.size()-1;
+    negated = false;
+    while (program_[root].op == NEGATION) {
+        root = program_[root].left;
+        negated = !negated;
+    }
+    return root;
+}
+
+unsigned int SentenceProgram::countValue(const Domain& d,
+        const SISet* where,
+        Registers& regs,
+        std::size_t root) const {
+    const Instruction& instr = program_[root];
+    if (instr.op == LIQUID && where == NULL) {
+        // every interval inside the merged segments, which don't overlap
+        std::vector<SISet> parts(1);
+        parts[0].swap(regs[instr.left]);
+        parts[0].setForceLiquid(true);
+        return unionOf(parts, true, d.maxInterval()).disjointSize();
+    }
+    SISet& sat = regs[root];
+    sat.setForceLiquid(false);
+    if (where) sat = intersection(sat, *where);
+    sat.makeDisjoint();
+    unsigned int satisfied = sat.disjointSize();
+    sat.clear();
+    return satisfied;
+}
+
+bool SentenceProgram::sameShape(const SentenceProgram& other) const {
+    if (program_.size() != other.program_.size()) return false;
+    if (atoms_.size() != other.atoms_.size()) return false;
+    for (std::size_t i = 0; i < program_.size(); i++) {
+        const Instruction& a = program_[i];
+        const Instruction& b = other.program_[i];
+        if (a.op != b.op || a.forceLiquid != b.forceLiquid || a.left != b.left || a.right != b.right
+                || a.args != b.args || a.without != b.without) {
+            return false;
+        }
+        switch (a.op) {
+        case ATOM:
+            if (a.atoms != b.atoms) return false;
+            break;
+        case BOOLLIT:
+            if (static_cast<const BoolLit&>(*a.node).value() != static_cast<const BoolLit&>(*b.node).value()) return false;
+            break;
+        case CONJUNCTION:
+            if (static_cast<const Conjunction&>(*a.node).relations()
+                    != static_cast<const Conjunction&>(*b.node).relations()) return false;
+            break;
+        case DIAMOND:
+            if (static_cast<const DiamondOp&>(*a.node).relations()
+                    != static_cast<const DiamondOp&>(*b.node).relations()) return false;
+            break;
+        case SENTENCE:
+            return false;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+void SentenceProgram::countBatch(const std::vector<const SentenceProgram*>& programs,
+        const Model& m,
+        const Domain& d,
+        const std::vector<const SISet*>& wheres,
+        std::vector<Registers>& regs,
+        std::vector<Count>& counts) {
+    counts.resize(programs.size());
+    if (programs.empty()) return;
+    const SentenceProgram& shape = *programs[0];
+    if (shape.program_.empty()) throw std::logic_error("SentenceProgram::countBatch(): program is empty");
+    for (std::size_t k = 1; k < programs.size(); k++) {
+        if (!shape.sameShape(*programs[k])) {
+            throw std::invalid_argument("SentenceProgram::countBatch(): programs don't have the same shape");
+        }
+    }
+    if (regs.size() < programs.size()) regs.resize(programs.size());
+    for (std::size_t k = 0; k < programs.size(); k++) {
+        if (regs[k].size() < shape.size()) regs[k].resize(shape.size());
+    }
+
+    bool negated;
+    std::size_t root = shape.countedRoot(negated);
+    const Instruction& rootInstr = shape.program_[root];
+    for (std::size_t i = rootInstr.first; i <= root; i++) {
+        const Instruction& instr = shape.program_[i];
+        for (std::size_t k = 0; k < programs.size(); k++) {
+            // a liquid root counted on the whole timeline only needs its child
+            if (i == root && instr.op == LIQUID && wheres[k] == NULL) continue;
+            programs[k]->execute(instr, m, d, regs[k], regs[k][i]);
+        }
+    }
+
+    for (std::size_t k = 0; k < programs.size(); k++) {
+        Count& count = counts[k];
+        count.total = (wheres[k] ? wheres[k]->size() : d.maxSpanInterval().size());
+        count.satisfied = shape.countValue(d, wheres[k], regs[k], root);
+        if (negated) count.satisfied = count.total - count.satisfied;
+    }
+}
+
+bool SentenceProgram::fullySatisfied(const Model& m,
+        const Domain& d,
+        const SISet* where,
+        Registers& regs,
+        Cache* cache) const {
+    if (program_.empty()) throw std::logic_error("SentenceProgram::fullySatisfied(): program is empty");
+    if (regs.size() < program_.size()) regs.resize(program_.size());
+    if (where) return covers(m, d, regs, cache, program_.size()-1, *where);
+    SISet everywhere(d.maxSpanInterval(), false, d.maxInterval());
+    return covers(m, d, regs, cache, program_.size()-1, everywhere);
+}
+
+bool SentenceProgram::covers(const Model& m,
+        const Domain& d,
+        Registers& regs,
+        Cache* cache,
+        std::size_t i,
+        const SISet& where) const {
+    const Instruction& instr = program_[i];
+    // liquid operands have to be combined before they mean anything
+    if (!instr.forceLiquid) {
+        if (instr.op == DISJUNCTION) {
+            // take away what each operand covers until nothing is left
+            SISet rest = where;
+            rest.setForceLiquid(false);
+            for (std::size_t a = 0; a < instr.args.size(); a++) {
+                evaluate(m, d, regs, cache, instr.args[a]);
+                SISet& sat = regs[instr.args[a]];
+                sat.setForceLiquid(false);
+                for (SISet::const_iterator it = sat.begin(); it != sat.end() && hasInterval(rest); it++) {
+                    rest.subtract(*it);
+                }
+                sat.clear();
+                if (!hasInterval(rest)) return true;
+            }
+            return false;
+        }
+        if (instr.op == INTERSECTION) {
+            for (std::size_t a = 0; a < instr.args.size(); a++) {
+                if (!covers(m, d, regs, cache, instr.args[a], where)) return false;
+            }
+            for (std::size_t a = 0; a < instr.without.size(); a++) {
+                evaluate(m, d, regs, cache, instr.without[a]);
+                SISet& sat = regs[instr.without[a]];
+                sat.setForceLiquid(false);
+                bool overlaps = meets(sat, where);
+                sat.clear();
+                if (overlaps) return false;
+            }
+            return true;
+        }
+        if (instr.op == NEGATION) {
+            evaluate(m, d, regs, cache, instr.left);
+            SISet& sat = regs[instr.left];
+            sat.setForceLiquid(false);
+            bool overlaps = meets(sat, where);
+            sat.clear();
+            return !overlaps;
+        }
+    }
+
+    // check the intervals of where one at a time
+    evaluate(m, d, regs, cache, i);
+    SISet& sat = regs[i];
+    sat.setForceLiquid(false);
+    bool covered = true;
+    for (SISet::const_iterator wIt = where.begin(); wIt != where.end() && covered; wIt++) {
+        SISet rest(*wIt, false, where.maxInterval());
+        for (SISet::const_iterator it = sat.begin(); it != sat.end() && hasInterval(rest); it++) {
+            rest.subtract(*it);
+        }
+        covered = !hasInterval(rest);
+    }
+    sat.clear();
+    return covered;
+}
+
+void SentenceProgram::evaluate(const Model& m,
+        const Domain& d,
+        Registers& regs,
+        Cache* cache,
+        std::size_t last) const {
+    if (regs.size() < program_.size()) regs.resize(program_.size());
+    std::size_t first = program_[last].first;
+    if (cache == NULL) {
+        for (std::size_t i = first; i <= last; i++) {
+            execute(program_[i], m, d, regs, regs[i]);
+        }
+        return;
+    }
+
+    std::vector<boost::uint64_t> versions(atoms_.size());
+    for (std::size_t i = 0; i < atoms_.size(); i++) {
+        versions[i] = m.atomVersion(*atoms_[i]);
+    }
+
+    // look for cached results from the top down, skipping the subtree
+    // under every hit
+    enum { RUN, CACHED, SKIP };
+    std::vector<char> state(last+1, RUN);
+    std::size_t i = last+1;
+    while (i > first) {
+        i--;
+        const Instruction& instr = program_[i];
+        if (!instr.cacheable) continue;
+        SubformulaKey key = keyOf(instr, versions);
+        if (cache->count(key) == 0) continue;
+        regs[i] = cache->get(key);
+        state[i] = CACHED;
+        std::fill(state.begin() + instr.first, state.begin() + i, (char)SKIP);
+        i = instr.first;
+    }
+
+    for (i = first; i <= last; i++) {
+        if (state[i] != RUN) continue;
+        const Instruction& instr = program_[i];
+        execute(instr, m, d, regs, regs[i]);
+        if (instr.cacheable) cache->insert(keyOf(instr, versions), regs[i]);
+    }
+}
+
+SentenceProgram::SubformulaKey SentenceProgram::keyOf(const Instruction& instr,
+        const std::vector<boost::uint64_t>& versions) const {
+    SubformulaKey key;
+    key.node = instr.node;
+    key.forceLiquid = instr.forceLiquid;
+    key.composed = instr.composed;
+    key.versions.reserve(instr.atoms.size());
+    for (std::vector<std::size_t>::const_iterator it = instr.atoms.begin(); it != instr.atoms.end(); it++) {
+        key.versions.push_back(versions[*it]);
+    }
+    return key;
+}
+
+void SentenceProgram::execute(const Instruction& instr,
+        const Model& m,
+        const Domain& d,
+        Registers& regs,
+        SISet& out) const {
+    switch (instr.op) {
+    case ATOM: {
+        // from this program's atoms, which may not be instr's own when
+        // running the instructions of a program of the same shape
+        const Atom& a = *atoms_[instr.atoms.front()];
+        if (m.hasAtom(a)) {
+            out = m.getAtom(a);
+            out.setForceLiquid(instr.forceLiquid);
+        } else {
+            out = SISet(instr.forceLiquid, d.maxInterval());
+        }
+        break;
+    }
+    case BOOLLIT:
+        if (static_cast<const BoolLit&>(*instr.node).value()) {
+            out = SISet(d.maxSpanInterval(), instr.forceLiquid, d.maxInterval());
+        } else {
+            out = SISet(instr.forceLiquid, d.maxInterval());
+        }
+        break;
+    case NEGATION: {
+        SISet& sat = regs[instr.left];
+        sat.setForceLiquid(instr.forceLiquid);
+        out = sat.compliment();
+        sat.clear();
+        break;
+    }
+    case CONJUNCTION: {
+        SISet& leftSat = regs[instr.left];
+        SISet& rightSat = regs[instr.right];
+        leftSat.setForceLiquid(false);
+        rightSat.setForceLiquid(false);
+        const std::set<Interval::INTERVAL_RELATION>& rels
+            = static_cast<const Conjunction&>(*instr.node).relations();
+        out = composedOf(leftSat, rightSat, rels, d.maxSpanInterval());
+        leftSat.clear();
+        rightSat.clear();
+        break;
+    }
+    case INTERSECTION:
+    case SEQUENCE:
+    case DISJUNCTION: {
+        std::vector<SISet> parts(instr.args.size());
+        for (std::size_t i = 0; i < instr.args.size(); i++) {
+            parts[i].swap(regs[instr.args[i]]);
+            if (instr.op != SEQUENCE) parts[i].setForceLiquid(instr.forceLiquid);
+        }
+        std::vector<SISet> without(instr.without.size());
+        for (std::size_t i = 0; i < instr.without.size(); i++) {
+            without[i].swap(regs[instr.without[i]]);
+            without[i].setForceLiquid(instr.forceLiquid);
+        }
+        if (instr.op == INTERSECTION) out = intersectionOf(parts, without, instr.forceLiquid, d.maxSpanInterval());
+        else if (instr.op == SEQUENCE) out = sequenceOf(parts, d.maxSpanInterval());
+        else out = unionOf(parts, instr.forceLiquid, d.maxInterval());
+        break;
+    }
+    case DIAMOND: {
+        if (instr.forceLiquid) throw std::runtime_error("DiamondOp::doSatisfied(): given parameter forceLiquid=true, but diamond op is a non liquid operator!");
+        SISet& sat = regs[instr.left];
+        sat.setForceLiquid(false);
+        const std::set<Interval::INTERVAL_RELATION>& rels
+            = static_cast<const DiamondOp&>(*instr.node).relations();
+        SpanInterval universe = d.maxSpanInterval();
+        out = SISet(false, sat.maxInterval());
+        for (SISet::const_iterator sIt = sat.begin(); sIt != sat.end(); sIt++) {
+            for (std::set<Interval::INTERVAL_RELATION>::const_iterator relIt = rels.begin();
+                    relIt != rels.end();
+                    relIt++) {
+                boost::optional<SpanInterval> spr = sIt->satisfiesRelation(*relIt, universe);
+                if (spr) out.add(*spr);
+            }
+        }
+        sat.clear();
+        break;
+    }
+    case LIQUID:
+        out.swap(regs[instr.left]);
+        out.setForceLiquid(instr.forceLiquid);
+        regs[instr.left].clear();
+        break;
+    case SENTENCE:
+        out = instr.node->satisfied(m, d, instr.forceLiquid);
+        break;
+    }
+}
+
+SISet SentenceProgram::dSatisfiedDelta(const Model& m,
+        const Domain& d,
+        const SISet& where,
+        const SISet& previous,
+        const Move& move,
+        Registers& regs) const {
+    if (!hasDelta_) throw std::logic_error("SentenceProgram::dSatisfiedDelta(): program has nodes that can't be restricted");
+    if (regs.size() < program_.size()) regs.resize(program_.size());
+    std::size_t root = program_.size()-1;
+
+    Registers regions(program_.size());
+    reach(move, d, regions);
+    regions[root] = intersection(regions[root], where);
+    if (regions[root].empty()) return previous;
+    demand(d, regions);
+    evaluateOn(m, d, regs, regions);
+
+    // previous stays disjoint after cutting out the region, so only the
+    // fresh part has to be made disjoint before splicing it in
+    SISet result = previous;
+    for (SISet::const_iterator it = regions[root].begin(); it != regions[root].end(); it++) {
+        result.subtract(*it);
+    }
+    regs[root].setForceLiquid(false);
+    regs[root].makeDisjoint();
+    result.add(regs[root]);
+    regs[root].clear();
+    return result;
+}
+
+SISet SentenceProgram::dSatisfied(const Model& m, const Domain& d, const SISet& where, Registers& regs) const {
+    if (!hasDelta_) {
+        SISet set = satisfied(m, d, regs);
+        set = intersection(set, where);
+        set.makeDisjoint();
+        return set;
+    }
+    if (program_.empty()) throw std::logic_error("SentenceProgram::dSatisfied(): program is empty");
+    if (regs.size() < program_.size()) regs.resize(program_.size());
+    std::size_t root = program_.size()-1;
+
+    Registers regions(program_.size());
+    regions[root] = where;
+    regions[root].setForceLiquid(false);
+    demand(d, regions);
+    evaluateOn(m, d, regs, regions);
+
+    SISet set;
+    set.swap(regs[root]);
+    set.setForceLiquid(false);
+    set.makeDisjoint();
+    return set;
+}
+
+void SentenceProgram::evaluateOn(const Model& m,
+        const Domain& d,
+        Registers& regs,
+        const Registers& regions) const {
+    for (std::size_t i = 0; i < program_.size(); i++) {
+        if (regions[i].empty()) {
+            regs[i] = SISet(program_[i].forceLiquid, d.maxInterval());
+            continue;
+        }
+        const Instruction& instr = program_[i];
+        if (instr.op == NEGATION) {
+            // cheaper than taking the compliment over the whole timeline
+            SISet& sat = regs[instr.left];
+            regs[i] = regions[i];
+            for (SISet::const_iterator it = sat.begin(); it != sat.end(); it++) {
+                regs[i].subtract(*it);
+            }
+            sat.clear();
+            continue;
+        }
+        execute(instr, m, d, regs, regs[i]);
+        regs[i] = intersection(regs[i], regions[i]);
+    }
+}
+
+void SentenceProgram::reach(const Move& move, const Domain& d, Registers& regions) const {
+    Interval maxInterval = d.maxInterval();
+    SpanInterval universe = d.maxSpanInterval();
+    unsigned int minFrame = maxInterval.start();
+    unsigned int maxFrame = maxInterval.finish();
+
+    for (std::size_t i = 0; i < program_.size(); i++) {
+        const Instruction& instr = program_[i];
+        SISet& out = regions[i];
+        out = SISet(instr.forceLiquid, maxInterval);
+        switch (instr.op) {
+        case ATOM: {
+            // a change anywhere on the frames of a span can change any
+            // interval overlapping them (for liquid atoms, it merges or
+            // splits the segments around it)
+            boost::optional<Domain::atom_id> atomId = d.atomId(*atoms_[instr.atoms.front()]);
+            if (!atomId) break;     // no move can touch it
+            for (Move::change_const_iterator it = move.changes_begin(); it != move.changes_end(); it++) {
+                if (it->atom != atomId.get()) continue;
+                unsigned int from = it->where.start().start();
+                unsigned int to = it->where.finish().finish();
+                if (instr.forceLiquid) out.add(SpanInterval(from, to, from, to));
+                else out.add(SpanInterval(minFrame, to, from, maxFrame));
+            }
+            break;
+        }
+        case BOOLLIT:
+            break;
+        case NEGATION:
+            out.swap(regions[instr.left]);
+            out.setForceLiquid(instr.forceLiquid);
+            break;
+        case INTERSECTION:
+        case DISJUNCTION:
+            for (std::vector<std::size_t>::const_iterator it = instr.args.begin(); it != instr.args.end(); it++) {
+                out.add(regions[*it]);
+            }
+            for (std::vector<std::size_t>::const_iterator it = instr.without.begin(); it != instr.without.end(); it++) {
+                out.add(regions[*it]);
+            }
+            break;
+        case DIAMOND: {
+            const std::set<Interval::INTERVAL_RELATION>& rels
+                = static_cast<const DiamondOp&>(*instr.node).relations();
+            const SISet& r = regions[instr.left];
+            for (SISet::const_iterator it = r.begin(); it != r.end(); it++) {
+                for (std::set<Interval::INTERVAL_RELATION>::const_iterator relIt = rels.begin();
+                        relIt != rels.end();
+                        relIt++) {
+                    boost::optional<SpanInterval> spr = it->satisfiesRelation(*relIt, universe);
+                    if (spr) out.add(*spr);
+                }
+            }
+            break;
+        }
+        case LIQUID: {
+            const SISet& r = regions[instr.left];
+            for (SISet::const_iterator it = r.begin(); it != r.end(); it++) {
+                out.add(SpanInterval(minFrame, it->finish().finish(), it->start().start(), maxFrame));
+            }
+            break;
+        }
+        case CONJUNCTION:
+        case SEQUENCE:
+        case SENTENCE:
+            throw std::logic_error("SentenceProgram::reach(): can't work out the reach of this node");
+        }
+    }
+}
+
+void SentenceProgram::demand(const Domain& d, Registers& regions) const {
+    Interval maxInterval = d.maxInterval();
+    SpanInterval universe = d.maxSpanInterval();
+
+    std::size_t i = program_.size()-1;
+    for (std::size_t j = 0; j < i; j++) regions[j].clear();
+    while (i > 0) {
+        const Instruction& instr = program_[i];
+        const SISet& need = regions[i];
+        switch (instr.op) {
+        case NEGATION:
+            regions[instr.left] = need;
+            break;
+        case INTERSECTION:
+        case DISJUNCTION:
+            for (std::vector<std::size_t>::const_iterator it = instr.args.begin(); it != instr.args.end(); it++) {
+                regions[*it] = need;
+            }
+            for (std::vector<std::size_t>::const_iterator it = instr.without.begin(); it != instr.without.end(); it++) {
+                regions[*it] = need;
+            }
+            break;
+        case LIQUID: {
+            SISet& childNeed = regions[instr.left];
+            childNeed = SISet(true, maxInterval);
+            for (SISet::const_iterator it = need.begin(); it != need.end(); it++) {
+                unsigned int from = it->start().start();
+                unsigned int to = it->finish().finish();
+                childNeed.add(SpanInterval(from, to, from, to));
+            }
+            break;
+        }
+        case DIAMOND: {
+            // the witnesses of the intervals we need
+            const std::set<Interval::INTERVAL_RELATION>& rels
+                = static_cast<const DiamondOp&>(*instr.node).relations();
+            SISet& childNeed = regions[instr.left];
+            childNeed = SISet(false, maxInterval);
+            for (SISet::const_iterator it = need.begin(); it != need.end(); it++) {
+                for (std::set<Interval::INTERVAL_RELATION>::const_iterator relIt = rels.begin();
+                        relIt != rels.end();
+                        relIt++) {
+                    boost::optional<SpanInterval> spr = it->satisfiesRelation(inverseRelation(*relIt), universe);
+                    if (spr) childNeed.add(*spr);
+                }
+            }
+            break;
+        }
+        case ATOM:
+        case BOOLLIT:
+        case CONJUNCTION:
+        case SEQUENCE:
+        case SENTENCE:
+            break;
+        }
+        i--;
+    }
+}
@@ -0,0 +1,359 @@
+/*
+ * SentenceProgram.h
+ */
+
+#ifndef SENTENCEPROGRAM_H_
+#define SENTENCEPROGRAM_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include "Sentence.h"
+#include "../../SISet.h"
+#include "../../LRUCache.h"
+
+class Model;
+class Domain;
+class Atom;
+struct Move;
+
+/**
+ * A sentence compiled into a flat evaluation program.
+ *
+ * Compiling walks the sentence tree once and emits one instruction per node
+ * in post-order, so the children of an instruction always come before it.
+ * Instruction i writes its result into register i; evaluating the program is
+ * a single loop over the instructions, with no virtual calls or shared_ptr
+ * traversal.  Whether a node has to produce a liquid set only depends on its
+ * ancestors, so it is worked out at compile time as well.
+ *
+ * The registers are supplied by the caller and can be reused between
+ * evaluations (and between programs).  Results are moved from child
+ * registers into their parent's rather than copied.
+ *
+ * satisfied() gives the same intervals as calling Sentence::satisfied() on
+ * the compiled sentence.  Nodes the compiler has no instruction for (such as
+ * ungrounded atoms) are evaluated by calling their satisfied() method.
+ * Trees of disjunctions, of "^" conjunctions and chains of ";"
+ * conjunctions are flattened as they are compiled, each into a single
+ * instruction over all of their operands.  Negated operands of a "^" keep
+ * their child's value and are subtracted, so the compliment is never built.
+ * A ";" chain is only flattened where no other relation or diamond composes
+ * its value: sequenceOf() merges its span intervals, and the approximate
+ * composition in composedOf() would then give different intervals.
+ *
+ * Formulas instantiated from the same template (the same formula over
+ * different constants) compile to programs of the same shape, differing
+ * only in the atoms they read.  countBatch() runs such programs together,
+ * one instruction at a time across all of them, so the instruction stream
+ * is only walked once.
+ *
+ * Evaluation can optionally go through a Cache of subformula results, keyed
+ * by the subformula and the Model::atomVersion() of every atom it mentions.
+ * Any subtree whose atoms haven't changed since it was cached is skipped
+ * entirely.  Subtrees containing nodes evaluated by satisfied() are never
+ * cached.
+ *
+ * After a Move, dSatisfiedDelta() can bring a previous result up to date
+ * without evaluating the whole timeline.  The intervals the move can have
+ * changed are worked out bottom-up from the frames it touches (widened by
+ * each diamond on the way up), and the program is then run with every
+ * register restricted to what its parent needs to decide those intervals.
+ * The fresh part is spliced into the previous result.  The same
+ * restriction is used by dSatisfied() with a quantification, so only the
+ * quantified part of the timeline is evaluated.  This only gives the
+ * same answer as a full evaluation when every operator computes its result
+ * exactly; conjunctions with Allen relations other than = and diamonds over
+ * o, oi, s, d or f are approximated in composedOf() and
+ * SpanInterval::satisfiesRelation(), so programs using them have
+ * hasDelta() false.
+ */
+class SentenceProgram {
+public:
+    typedef std::vector<SISet> Registers;
+
+    /**
+     * Identifies the value of a subformula: its node, whether it was
+     * evaluated as liquid, whether it was evaluated under a relation or
+     * diamond (which keeps ";" chains pairwise), and the versions of the
+     * atoms it mentions.
+     */
+    struct SubformulaKey {
+        const Sentence* node;
+        bool forceLiquid;
+        bool composed;
+        std::vector<boost::uint64_t> versions;
+
+        bool operator<(const SubformulaKey& b) const;
+    };
+
+    /**
+     * Cache of subformula results.  Results are only valid for the domain
+     * they were computed in, so clear the cache when switching domains.
+     */
+    typedef LRUCache<SubformulaKey, SISet> Cache;
+
+    /**
+     * How many of the intervals a sentence is evaluated on it is true on.
+     */
+    struct Count {
+        unsigned int satisfied;   // intervals where the sentence is true
+        unsigned int total;       // intervals it was evaluated on
+
+        bool fullySatisfied() const;
+    };
+
+    /**
+     * Construct an empty program.  An empty program can't be evaluated.
+     */
+    SentenceProgram();
+
+    /**
+     * Compile a sentence.  The program keeps a reference to the sentence,
+     * which should not be modified while the program is in use.
+     *
+     * @param s  the sentence to compile
+     */
+    explicit SentenceProgram(boost::shared_ptr<const Sentence> s);
+
+    /**
+     * Get the number of instructions (and registers) in this program.
+     */
+    std::size_t size() const;
+
+    /**
+     * Get the sentence this program was compiled from.
+     */
+    boost::shared_ptr<const Sentence> sentence() const;
+
+    /**
+     * Evaluate the program, equivalent to sentence()->satisfied(m, d, false).
+     *
+     * @param m     the model to evaluate on
+     * @param d     the domain the model belongs to
+     * @param regs  scratch registers; resized as needed
+     * @return  the set of intervals where the sentence is true
+     */
+    SISet satisfied(const Model& m, const Domain& d, Registers& regs) const;
+
+    /**
+     * Evaluate the program, reusing and adding to the cached results of its
+     * subformulas.
+     *
+     * @param m      the model to evaluate on
+     * @param d      the domain the model belongs to
+     * @param regs   scratch registers; resized as needed
+     * @param cache  subformula results computed earlier in domain d
+     * @return  the set of intervals where the sentence is true
+     */
+    SISet satisfied(const Model& m, const Domain& d, Registers& regs, Cache& cache) const;
+
+    SISet dSatisfied(const Model& m, const Domain& d, Registers& regs) const;
+
+    /**
+     * Evaluate the program only where it is needed to decide the intervals
+     * of where.  When hasDelta() is true, every register is cut down to the
+     * part of the timeline its parent needs (widened through diamonds and
+     * liquid operators), so nothing outside where is computed.  Otherwise
+     * the whole timeline is evaluated and intersected with where.
+     *
+     * @param m      the model to evaluate on
+     * @param d      the domain the model belongs to
+     * @param where  the intervals to evaluate on
+     * @param regs   scratch registers; resized as needed
+     * @return  the disjoint set of intervals of where the sentence is true on
+     */
+    SISet dSatisfied(const Model& m, const Domain& d, const SISet& where, Registers& regs) const;
+    SISet dSatisfied(const Model& m, const Domain& d, Registers& regs, Cache& cache) const;
+    SISet dSatisfied(const Model& m, const Domain& d, const SISet& where, Registers& regs, Cache& cache) const;
+
+    /**
+     * Count the intervals where the program is true, equivalent to the
+     * size() of dSatisfied() but without building the disjoint set when the
+     * root allows it.  Negations at the root are counted as the intervals
+     * their child is false on, and a liquid root evaluated on the whole
+     * timeline is counted from its merged segments.
+     *
+     * @param m      the model to evaluate on
+     * @param d      the domain the model belongs to
+     * @param where  if not NULL, the intervals to count on; otherwise all
+     *   of d.maxSpanInterval()
+     * @param regs   scratch registers; resized as needed
+     * @param cache  if not NULL, subformula results computed earlier in d
+     * @return  how many intervals of where the program is true on
+     */
+    Count count(const Model& m, const Domain& d, const SISet* where, Registers& regs, Cache* cache=0) const;
+
+    /**
+     * Check whether the program is true on every interval of where, the same
+     * as count(...).fullySatisfied() but stopping at the first interval
+     * found to be unsatisfied.  The operands of a disjunction are evaluated
+     * one at a time until they cover where, and each operand of a "^"
+     * conjunction is checked on its own, stopping at the first one that
+     * fails.
+     *
+     * @param m      the model to evaluate on
+     * @param d      the domain the model belongs to
+     * @param where  if not NULL, the intervals to check; otherwise all of
+     *   d.maxSpanInterval()
+     * @param regs   scratch registers; resized as needed
+     * @param cache  if not NULL, subformula results computed earlier in d
+     * @return  true if the program is satisfied on all of where
+     */
+    bool fullySatisfied(const Model& m, const Domain& d, const SISet* where, Registers& regs, Cache* cache=0) const;
+
+    /**
+     * Whether other runs the same instructions as this program, differing
+     * at most in which atoms they read, as the programs of two instances of
+     * a formula template do.  Programs with nodes evaluated by calling
+     * their satisfied() never have the same shape as another.
+     *
+     * @param other  the program to compare with
+     * @return  true if countBatch() can run the two programs together
+     */
+    bool sameShape(const SentenceProgram& other) const;
+
+    /**
+     * Count several programs of the same shape at once, the same as calling
+     * count() on each.  Each instruction is run for every program before
+     * moving on to the next one.
+     *
+     * @param programs  the programs to count; all must have the same shape
+     * @param m         the model to evaluate on
+     * @param d         the domain the model belongs to
+     * @param wheres    for each program, the intervals to count on, or NULL
+     *   for all of d.maxSpanInterval()
+     * @param regs      scratch registers, one set per program; resized as
+     *   needed
+     * @param counts    set to the count of each program
+     */
+    static void countBatch(const std::vector<const SentenceProgram*>& programs,
+            const Model& m,
+            const Domain& d,
+            const std::vector<const SISet*>& wheres,
+            std::vector<Registers>& regs,
+            std::vector<Count>& counts);
+
+    /**
+     * Whether dSatisfiedDelta() can be used with this program, and whether
+     * dSatisfied() with a quantification only evaluates that part of the
+     * timeline; false when some node is evaluated by calling its
+     * satisfied() or is approximated.
+     */
+    bool hasDelta() const;
+
+    /**
+     * Bring the result of dSatisfied() up to date after a move, only
+     * recomputing the intervals the move can have changed.
+     *
+     * @param m         the model after the move was applied
+     * @param d         the domain the model belongs to
+     * @param where     the quantification previous was restricted to
+     * @param previous  dSatisfied() (with where) of the model before the move
+     * @param move      the move that was applied
+     * @param regs      scratch registers; resized as needed
+     * @return  the same set as dSatisfied(m, d, where, regs)
+     */
+    SISet dSatisfiedDelta(const Model& m,
+            const Domain& d,
+            const SISet& where,
+            const SISet& previous,
+            const Move& move,
+            Registers& regs) const;
+private:
+    enum OpCode {
+        ATOM,
+        BOOLLIT,
+        NEGATION,
+        CONJUNCTION,    // two operands composed under Allen relations
+        INTERSECTION,   // "^" (or liquid) conjunctions, see intersectionOf()
+        SEQUENCE,       // a chain of ";" conjunctions, see sequenceOf()
+        DISJUNCTION,    // see unionOf()
+        DIAMOND,
+        LIQUID,
+        SENTENCE    // call the node's satisfied()
+    };
+
+    struct Instruction {
+        OpCode op;
+        bool forceLiquid;
+        bool composed;        // whether a relation or diamond above composes the value
+        std::size_t left;     // register of the (first) argument
+        std::size_t right;    // register of the second argument
+        std::vector<std::size_t> args;    // registers of the operands of n-ary ops
+        std::vector<std::size_t> without; // negated operands of an INTERSECTION, uncomplemented
+        const Sentence* node;
+        std::size_t first;    // first instruction of this node's subtree
+        bool cacheable;
+        std::vector<std::size_t> atoms;   // positions in atoms_ used by the subtree
+    };
+
+    std::size_t compile(const Sentence& s, bool forceLiquid, bool composed);
+    // run the subtree of instruction last, leaving its value in regs[last]
+    void evaluate(const Model& m, const Domain& d, Registers& regs, Cache* cache, std::size_t last) const;
+    void execute(const Instruction& instr, const Model& m, const Domain& d, Registers& regs, SISet& out) const;
+    // run the whole program with register i restricted to regions[i]
+    void evaluateOn(const Model& m, const Domain& d, Registers& regs, const Registers& regions) const;
+    // the instruction count() evaluates, with the negations above it
+    // stripped off; negated is set if there were an odd number of them
+    std::size_t countedRoot(bool& negated) const;
+    // count the value of the counted root, left in regs by evaluating it
+    // (or only its child, for a liquid root counted on the whole timeline)
+    unsigned int countValue(const Domain& d, const SISet* where, Registers& regs, std::size_t root) const;
+    // whether the subtree of instruction i is true everywhere in where
+    bool covers(const Model& m, const Domain& d, Registers& regs, Cache* cache, std::size_t i, const SISet& where) const;
+    // whether the subtree at i is evaluated without calling satisfied()
+    bool selfContained(std::size_t i) const;
+    // whether the instruction gives the same intervals when its arguments
+    // are cut down to part of the timeline
+    static bool restrictable(const Instruction& instr);
+    SubformulaKey keyOf(const Instruction& instr, const std::vector<boost::uint64_t>& versions) const;
+    // the intervals where each instruction's value can be changed by move
+    void reach(const Move& move, const Domain& d, Registers& regions) const;
+    // replace regions[i] with the intervals each instruction has to be
+    // evaluated on to decide regions[i] of the root i
+    void demand(const Domain& d, Registers& regions) const;
+
+    boost::shared_ptr<const Sentence> s_;
+    std::vector<Instruction> program_;
+    std::vector<const Atom*> atoms_;    // distinct grounded atoms in the sentence
+    bool hasDelta_;
+};
+
+// IMPLEMENTATION
+inline SentenceProgram::SentenceProgram()
+    : s_(), program_(), atoms_(), hasDelta_(false) {}
+
+inline std::size_t SentenceProgram::size() const { return program_.size();}
+inline boost::shared_ptr<const Sentence> SentenceProgram::sentence() const { return s_;}
+inline bool SentenceProgram::hasDelta() const { return hasDelta_;}
+
+inline bool SentenceProgram::Count::fullySatisfied() const { return satisfied == total;}
+
+inline bool SentenceProgram::SubformulaKey::operator<(const SubformulaKey& b) const {
+    if (node != b.node) return node < b.node;
+    if (forceLiquid != b.forceLiquid) return forceLiquid < b.forceLiquid;
+    if (composed != b.composed) return composed < b.composed;
+    return versions < b.versions;
+}
+
+inline SISet SentenceProgram::dSatisfied(const Model& m, const Domain& d, Registers& regs) const {
+    SISet set = satisfied(m, d, regs);
+    set.makeDisjoint();
+    return set;
+}
+
+inline SISet SentenceProgram::dSatisfied(const Model& m, const Domain& d, Registers& regs, Cache& cache) const {
+    SISet set = satisfied(m, d, regs, cache);
+    set.makeDisjoint();
+    return set;
+}
+
+inline SISet SentenceProgram::dSatisfied(const Model& m, const Domain& d, const SISet& where, Registers& regs, Cache& cache) const {
+    SISet set = satisfied(m, d, regs, cache);
+    set = intersection(set, where);
+    set.makeDisjoint();
+    return set;
+}
+
+#endif /* SENTENCEPROGRAM_H_ */
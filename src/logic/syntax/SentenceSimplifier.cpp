@@ -0,0 +1,174 @@
+/*
+ * SentenceSimplifier.cpp
+ */
+
+#include <set>
+#include "SentenceSimplifier.h"
+#include "BoolLit.h"
+#include "Cardinality.h"
+#include "Conjunction.h"
+#include "DiamondOp.h"
+#include "Disjunction.h"
+#include "LiquidOp.h"
+#include "Negation.h"
+
+namespace {
+    bool isBoolLit(const Sentence& s, bool value) {
+        return s.getTypeCode() == BoolLit::TypeCode && static_cast<const BoolLit&>(s).value() == value;
+    }
+
+    boost::shared_ptr<Sentence> makeBoolLit(bool value) {
+        return boost::shared_ptr<Sentence>(new BoolLit(value));
+    }
+
+    // whether a is the negation of b
+    bool isNegationOf(const Sentence& a, const Sentence& b) {
+        return a.getTypeCode() == Negation::TypeCode && *static_cast<const Negation&>(a).sentence() == b;
+    }
+
+    bool hasTQConstraints(const Conjunction& c) {
+        return !c.tqconstraints().first.empty() || !c.tqconstraints().second.empty();
+    }
+
+    // the union of the relations of a and b
+    template <class T>
+    std::set<Interval::INTERVAL_RELATION> mergedRelations(const T& a, const T& b) {
+        std::set<Interval::INTERVAL_RELATION> rels = a.relations();
+        rels.insert(b.relations().begin(), b.relations().end());
+        return rels;
+    }
+}
+
+std::size_t countNodes(const Sentence& s) {
+    switch (s.getTypeCode()) {
+    case Negation::TypeCode:
+        return 1 + countNodes(*static_cast<const Negation&>(s).sentence());
+    case Conjunction::TypeCode: {
+        const Conjunction& con = static_cast<const Conjunction&>(s);
+        return 1 + countNodes(*con.left()) + countNodes(*con.right());
+    }
+    case Disjunction::TypeCode: {
+        const Disjunction& dis = static_cast<const Disjunction&>(s);
+        return 1 + countNodes(*dis.left()) + countNodes(*dis.right());
+    }
+    case DiamondOp::TypeCode:
+        return 1 + countNodes(*static_cast<const DiamondOp&>(s).sentence());
+    case LiquidOp::TypeCode:
+        return 1 + countNodes(*static_cast<const LiquidOp&>(s).sentence());
+    case Cardinality::TypeCode:
+        return 1 + static_cast<const Cardinality&>(s).atoms().size();
+    default:
+        return 1;
+    }
+}
+
+boost::shared_ptr<Sentence> SentenceSimplifier::simplify(const boost::shared_ptr<Sentence>& s) {
+    if (!s) return s;
+    boost::shared_ptr<Sentence> simplified = simplify(s, false);
+    if (simplified != s) eliminated_ += countNodes(*s) - countNodes(*simplified);
+    return simplified;
+}
+
+boost::shared_ptr<Sentence> SentenceSimplifier::simplify(const boost::shared_ptr<Sentence>& s, bool forceLiquid) {
+    switch (s->getTypeCode()) {
+    case Negation::TypeCode: {
+        Negation& neg = static_cast<Negation&>(*s);
+        boost::shared_ptr<Sentence> child = simplify(neg.sentence(), forceLiquid);
+        if (child->getTypeCode() == BoolLit::TypeCode) {
+            return makeBoolLit(!static_cast<const BoolLit&>(*child).value());
+        }
+        if (child->getTypeCode() == Negation::TypeCode) return static_cast<Negation&>(*child).sentence();
+        if (child == neg.sentence()) return s;
+        boost::shared_ptr<Negation> copy(new Negation(neg));
+        copy->setSentence(child);
+        return copy;
+    }
+    case Disjunction::TypeCode: {
+        Disjunction& dis = static_cast<Disjunction&>(*s);
+        boost::shared_ptr<Sentence> left = simplify(dis.left(), forceLiquid);
+        boost::shared_ptr<Sentence> right = simplify(dis.right(), forceLiquid);
+        if (isBoolLit(*left, true) || isBoolLit(*right, true)) return makeBoolLit(true);
+        if (isBoolLit(*left, false)) return right;
+        if (isBoolLit(*right, false) || *left == *right) return left;
+        if (isNegationOf(*left, *right) || isNegationOf(*right, *left)) return makeBoolLit(true);
+
+        // a disjunction of the same operand(s) under different relations is
+        // one operator under all of them
+        if (left->getTypeCode() == DiamondOp::TypeCode && right->getTypeCode() == DiamondOp::TypeCode) {
+            const DiamondOp& a = static_cast<const DiamondOp&>(*left);
+            const DiamondOp& b = static_cast<const DiamondOp&>(*right);
+            if (*a.sentence() == *b.sentence() && a.tqconstraints() == b.tqconstraints()) {
+                std::set<Interval::INTERVAL_RELATION> rels = mergedRelations(a, b);
+                boost::shared_ptr<DiamondOp> merged(new DiamondOp(a));
+                merged->setRelations(rels.begin(), rels.end());
+                return merged;
+            }
+        }
+        if (!forceLiquid && left->getTypeCode() == Conjunction::TypeCode
+                && right->getTypeCode() == Conjunction::TypeCode) {
+            const Conjunction& a = static_cast<const Conjunction&>(*left);
+            const Conjunction& b = static_cast<const Conjunction&>(*right);
+            if (*a.left() == *b.left() && *a.right() == *b.right()
+                    && !hasTQConstraints(a) && !hasTQConstraints(b)) {
+                std::set<Interval::INTERVAL_RELATION> rels = mergedRelations(a, b);
+                boost::shared_ptr<Conjunction> merged(new Conjunction(a));
+                merged->setRelations(rels.begin(), rels.end());
+                return merged;
+            }
+        }
+
+        if (left == dis.left() && right == dis.right()) return s;
+        boost::shared_ptr<Disjunction> copy(new Disjunction(dis));
+        copy->setLeft(left);
+        copy->setRight(right);
+        return copy;
+    }
+    case Conjunction::TypeCode: {
+        Conjunction& con = static_cast<Conjunction&>(*s);
+        bool intersection = con.isIntersection(forceLiquid);
+        // operands of other relations are never evaluated as liquid
+        boost::shared_ptr<Sentence> left = simplify(con.left(), intersection && forceLiquid);
+        boost::shared_ptr<Sentence> right = simplify(con.right(), intersection && forceLiquid);
+        if (isBoolLit(*left, false) || isBoolLit(*right, false)) return makeBoolLit(false);
+        if (intersection && !hasTQConstraints(con)) {
+            if (isBoolLit(*left, true)) return right;
+            if (isBoolLit(*right, true) || *left == *right) return left;
+        }
+        if (left == con.left() && right == con.right()) return s;
+        boost::shared_ptr<Conjunction> copy(new Conjunction(con));
+        copy->setLeft(left);
+        copy->setRight(right);
+        return copy;
+    }
+    case DiamondOp::TypeCode: {
+        DiamondOp& dia = static_cast<DiamondOp&>(*s);
+        boost::shared_ptr<Sentence> child = simplify(dia.sentence(), false);
+        if (isBoolLit(*child, false)) return child;
+        if (dia.relations().size() == 1 && *dia.relations().begin() == Interval::EQUALS
+                && dia.tqconstraints().empty()) {
+            return child;
+        }
+        if (child == dia.sentence()) return s;
+        boost::shared_ptr<DiamondOp> copy(new DiamondOp(dia));
+        copy->setSentence(child);
+        return copy;
+    }
+    case LiquidOp::TypeCode: {
+        // kept even around constants: [true] is only true at liquid intervals
+        LiquidOp& liq = static_cast<LiquidOp&>(*s);
+        boost::shared_ptr<Sentence> child = simplify(liq.sentence(), true);
+        if (child == liq.sentence()) return s;
+        boost::shared_ptr<LiquidOp> copy(new LiquidOp(liq));
+        copy->setSentence(child);
+        return copy;
+    }
+    case Cardinality::TypeCode: {
+        // one atom can't be true more than once
+        const Cardinality& card = static_cast<const Cardinality&>(*s);
+        if (card.kind() == Cardinality::AT_MOST_ONE && card.atoms().size() <= 1) return makeBoolLit(true);
+        return s;
+    }
+    default:
+        return s;   // leaves
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * SentenceSimplifier.h
+ */
+
+#ifndef SENTENCESIMPLIFIER_H_
+#define SENTENCESIMPLIFIER_H_
+
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+#include "Sentence.h"
+
+/**
+ * Rewrites sentences into equivalent, smaller ones, so that constant parts of
+ * a formula aren't evaluated again for every model.
+ *
+ * simplify() works bottom up and applies these rules:
+ *   - true and false are folded through negations, disjunctions and
+ *     conjunctions (a ^ true is only a when the conjunction intersects);
+ *     only false is folded through diamonds, since <>{r} true doesn't hold
+ *     at every interval
+ *   - !!a becomes a
+ *   - a v a and a ^ a (intersecting) become a, and a v !a becomes true
+ *   - <>{=} a becomes a
+ *   - <>{r} a v <>{s} a becomes <>{r,s} a, and likewise for two conjunctions
+ *     of the same operands under different relations
+ *   - at1(a) becomes true
+ *
+ * The rewritten sentence means the same as the original, but its evaluated
+ * result can differ: diamonds and relational conjunctions are evaluated
+ * approximately from the span intervals of their operands, and those change
+ * when an operand is folded.  For example <>{s} (P -> P) becomes <>{s} true,
+ * whose result doesn't depend on where P holds; the original's does, and it
+ * misses intervals that start where P changes value.
+ *
+ * Like SentenceInterner, nodes are only copied when something below them
+ * changed, so the sentence passed in is never modified.  The simplifier keeps
+ * a running count of the nodes it has eliminated.
+ */
+class SentenceSimplifier {
+public:
+    SentenceSimplifier();
+
+    /**
+     * Get a simplified version of a sentence.
+     *
+     * @param s  the sentence to simplify
+     * @return  a sentence equivalent to s
+     */
+    boost::shared_ptr<Sentence> simplify(const boost::shared_ptr<Sentence>& s);
+
+    /**
+     * Get the number of nodes removed by simplify() so far.
+     */
+    std::size_t eliminated() const;
+
+    void clear();
+private:
+    boost::shared_ptr<Sentence> simplify(const boost::shared_ptr<Sentence>& s, bool forceLiquid);
+
+    std::size_t eliminated_;
+};
+
+/**
+ * Get the number of nodes in a sentence, counting shared subformulas once
+ * for every place they appear.
+ */
+std::size_t countNodes(const Sentence& s);
+
+// IMPLEMENTATION
+inline SentenceSimplifier::SentenceSimplifier() : eliminated_(0) {}
+inline std::size_t SentenceSimplifier::eliminated() const { return eliminated_;}
+inline void SentenceSimplifier::clear() { eliminated_ = 0;}
+
+#endif /* SENTENCESIMPLIFIER_H_ */
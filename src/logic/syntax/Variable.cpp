@@ -1,9 +1,10 @@
 
+#include <sstream>
 #include <string>
 #include "Variable.h"
 
 Variable::Variable(std::string name) 
-: name_(name)
+: name_(name), id_(0)
 {
 }
 
@@ -17,10 +18,16 @@ bool Variable::doEquals(const Term& t) const {
     if (var == NULL) {
         return false; // wrong type
     }
-    return var->name_ == name_;
+    return var->name_ == name_ && var->id_ == id_;
 }
 
 void Variable::doToString(std::string& str) const {
     str += "?";
     str += name_;
+    if (id_ != 0) {
+        // a typed variable, ?type:id
+        std::stringstream idStr;
+        idStr << id_;
+        str += ":" + idStr.str();
+    }
 }
@@ -0,0 +1,72 @@
+/*
+ * CompressedTimelineTest.cpp
+ */
+
+#define BOOST_TEST_MODULE CompressedTimeline
+#define BOOST_TEST_MAIN
+#include "../src/config.h"
+#ifdef USE_DYNAMIC_UNIT_TEST
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+#include "logic/ELSyntax.h"
+#include "logic/CompressedTimeline.h"
+#include "TestUtilities.h"
+
+BOOST_AUTO_TEST_CASE( segmentTest ) {
+    std::string facts("P(a) @ [1:10]\n"
+            "Q(a) @ [5:20]\n"
+            "R(a) @ [21:100]\n");
+    Domain d = loadDomainWithStreams(facts, "");
+    CompressedTimeline timeline(d);
+
+    // segments: [1:4] [5:10] [11:20] [21:100]
+    BOOST_REQUIRE_EQUAL(timeline.size(), 4);
+    BOOST_CHECK_EQUAL(timeline.frameInterval(), Interval(1,100));
+    BOOST_CHECK_EQUAL(timeline.maxInterval(), Interval(1,4));
+    BOOST_CHECK_EQUAL(timeline.segment(1), Interval(1,4));
+    BOOST_CHECK_EQUAL(timeline.segment(2), Interval(5,10));
+    BOOST_CHECK_EQUAL(timeline.segment(4), Interval(21,100));
+    BOOST_CHECK_EQUAL(timeline.compress(1), 1);
+    BOOST_CHECK_EQUAL(timeline.compress(7), 2);
+    BOOST_CHECK_EQUAL(timeline.compress(20), 3);
+    BOOST_CHECK_EQUAL(timeline.compress(100), 4);
+    BOOST_CHECK_THROW(timeline.segment(5), std::out_of_range);
+
+    // facts land on whole segments and round trip exactly
+    SISet q = d.lookupFact(Proposition(*boost::dynamic_pointer_cast<Atom>(getAsSentence("Q(a)")), true));
+    BOOST_CHECK_EQUAL(timeline.compress(q).toString(), "{[2:3]}");
+    BOOST_CHECK_EQUAL(timeline.expand(timeline.compress(q)), q);
+    BOOST_CHECK_EQUAL(timeline.compress(SpanInterval(1,10,21,100)), SpanInterval(1,2,4,4));
+}
+
+BOOST_AUTO_TEST_CASE( domainModelTest ) {
+    std::string facts("P(a) @ [1:10]\n"
+            "Q(a) @ [11:30]\n");
+    Domain d = loadDomainWithStreams(facts, "");
+    ELSentence quantified(getAsSentence("P(a) ; Q(a)"), 2.0, SISet(SpanInterval(5,5,25,25), false, Interval(1,30)));
+    d.addFormula(quantified);
+    CompressedTimeline timeline(d);
+
+    // segments: [1:4] [5:5] [6:10] [11:24] [25:25] [26:30]
+    BOOST_REQUIRE_EQUAL(timeline.size(), 6);
+    Domain compressed = timeline.compress(d);
+    BOOST_CHECK_EQUAL(compressed.maxInterval(), Interval(1,6));
+    BOOST_CHECK_EQUAL(compressed.atoms_size(), d.atoms_size());
+    BOOST_REQUIRE_EQUAL(compressed.formulas_size(), 1);
+    BOOST_CHECK_EQUAL(compressed.formulas_begin()->quantification().toString(), "{[(2, 2), (5, 5)]}");
+    BOOST_CHECK_EQUAL(compressed.formulas_begin()->weight(), 2.0);
+
+    // meets is preserved across segment boundaries
+    Model compressedModel = compressed.defaultModel();
+    BOOST_CHECK_EQUAL(compressedModel.toString(), "P(a) @ {[1:3]}\n"
+            "Q(a) @ {[4:6]}\n");
+    SISet sat = getAsSentence("P(a) ; Q(a)")->dSatisfied(compressedModel, compressed);
+    BOOST_CHECK(sat.includes(SpanInterval(1,1,6,6)));
+
+    Model expanded = timeline.expand(compressedModel);
+    BOOST_CHECK_EQUAL(expanded.maxInterval(), Interval(1,30));
+    BOOST_CHECK(expanded == d.defaultModel());
+}
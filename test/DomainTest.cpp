@@ -16,6 +16,8 @@
 #include "logic/Domain.h"
 #include "logic/ELSyntax.h"
 #include "logic/FOLParser.h"
+#include "logic/Moves.h"
+#include "ThreadPool.h"
 #include "../src/AllSerializationExports.h"
 
 BOOST_AUTO_TEST_CASE( addFactsFormulas ) {
@@ -302,6 +304,510 @@ BOOST_AUTO_TEST_CASE( randomModelTest ) {
     //std::cout << "random model: " << randomModel.toString() << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE( modifiableTest ) {
+    Domain d;
+    Atom pa = Atom("P");
+    pa.push_back(Constant("a"));
+    Atom qa = Atom("Q");
+    qa.push_back(Constant("a"));
+    SISet pTrue(true, Interval(1,20));
+    pTrue.add(SpanInterval(1,3));
+    pTrue.add(SpanInterval(10,12));
+    d.addFact(Proposition(pa, true), pTrue);
+    d.addFact(Proposition(pa, false), SISet(SpanInterval(15,16), true, Interval(1,20)));
+    d.addAtom(qa);
+
+    BOOST_CHECK(d.isModifiable(pa, SpanInterval(5,8)));
+    BOOST_CHECK(d.isModifiable(pa, SpanInterval(17,20)));
+    BOOST_CHECK(!d.isModifiable(pa, SpanInterval(2,2)));
+    BOOST_CHECK(!d.isModifiable(pa, SpanInterval(4,11)));
+    BOOST_CHECK(!d.isModifiable(pa, SpanInterval(16,18)));
+    BOOST_CHECK(!d.isModifiable(pa, SpanInterval(1,2,2,3)));
+    BOOST_CHECK(d.isModifiable(pa, SpanInterval(1,1,12,12)));
+    BOOST_CHECK(d.isModifiable(pa, SpanInterval(4,4,13,13)));
+    BOOST_CHECK(d.isModifiable(qa, SpanInterval(1,20)));
+
+    // agrees with the set-based computation
+    SISet where(SpanInterval(4,11), false, d.maxInterval());
+    BOOST_CHECK(d.getModifiableSISet(pa, where) != where);
+    BOOST_CHECK_EQUAL(d.getModifiableSISet(pa).toString(), "{[4:9], [13:14], [17:20]}");
+
+    d.setDontModifyObsPreds(false);
+    BOOST_CHECK(d.isModifiable(pa, SpanInterval(2,2)));
+}
+
+BOOST_AUTO_TEST_CASE( copyOnWriteTest ) {
+    Domain d;
+    Atom pa = Atom("P");
+    pa.push_back(Constant("a"));
+    Atom qa = Atom("Q");
+    qa.push_back(Constant("a"));
+    d.addFact(Proposition(pa, true), SISet(SpanInterval(1,5), true, Interval(1,10)));
+    d.addFormula(ELSentence(getAsSentence("P(a) ^ Q(a)"), 1.0));
+
+    // swapping out formulas on a copy doesn't touch the original
+    Domain copy = d;
+    copy.clearFormulas();
+    copy.addFormula(ELSentence(getAsSentence("Q(a)"), 2.0));
+    BOOST_CHECK_EQUAL(d.formulas_size(), 1);
+    BOOST_CHECK_EQUAL(copy.formulas_size(), 1);
+    BOOST_CHECK_EQUAL(copy.atoms_size(), 2);
+    BOOST_CHECK(d != copy);
+
+    // nor does adding facts or atoms to it
+    copy.addFact(Proposition(qa, false), SISet(SpanInterval(2,3), true, Interval(1,10)));
+    copy.addAtom(Atom("R"));
+    BOOST_CHECK(!d.hasFact(Proposition(qa, false)));
+    BOOST_CHECK(copy.hasFact(Proposition(qa, false)));
+    BOOST_CHECK_EQUAL(d.atoms_size(), 2);
+    BOOST_CHECK_EQUAL(copy.atoms_size(), 3);
+    BOOST_CHECK(d.isModifiable(qa, SpanInterval(2,2)));
+    BOOST_CHECK(!copy.isModifiable(qa, SpanInterval(2,2)));
+
+    d.setMaxInterval(Interval(0,20));
+    BOOST_CHECK_EQUAL(copy.maxInterval(), Interval(1,10));
+
+    Domain reweighted = d.replaceInfForms();
+    BOOST_CHECK(reweighted == d);
+}
+
+BOOST_AUTO_TEST_CASE( occurrenceIndexTest ) {
+    Domain d;
+    Atom pa = Atom("P");
+    pa.push_back(Constant("a"));
+    d.addFact(Proposition(pa, true), SISet(SpanInterval(1,5), true, Interval(1,10)));
+    d.addFormula(ELSentence(getAsSentence("P(a) ^ Q(a)"), 1.0));
+    d.addFormula(ELSentence(getAsSentence("R(a) v Q(a)"), 1.0));
+    d.addFormula(ELSentence(getAsSentence("!R(a)"), 1.0));
+
+    BOOST_REQUIRE_EQUAL(d.atoms_size(), 3);
+    BOOST_REQUIRE(d.atomId(pa));
+    std::size_t p = d.atomId(pa).get();
+    std::size_t q = d.atomId(*boost::dynamic_pointer_cast<Atom>(getAsSentence("Q(a)"))).get();
+    std::size_t r = d.atomId(*boost::dynamic_pointer_cast<Atom>(getAsSentence("R(a)"))).get();
+    BOOST_CHECK_EQUAL(p, 0);
+    BOOST_CHECK_EQUAL(d.atomById(p), pa);
+    BOOST_CHECK(!d.atomId(Atom("S")));
+
+    BOOST_CHECK_EQUAL(d.formulasWithAtom(p).size(), 1);
+    BOOST_CHECK_EQUAL(d.formulasWithAtom(q).size(), 2);
+    BOOST_CHECK_EQUAL(d.formulasWithAtom(q)[1], 1);
+    BOOST_CHECK_EQUAL(d.formulasWithAtom(r).size(), 2);
+    BOOST_CHECK_EQUAL(d.formulasWithAtom(r)[1], 2);
+    BOOST_CHECK_EQUAL(d.atomsInFormula(0).size(), 2);
+    BOOST_CHECK_EQUAL(d.atomsInFormula(2).size(), 1);
+    BOOST_CHECK_EQUAL(d.atomsInFormula(2)[0], r);
+
+    // replacing the formulas keeps the atom ids
+    Domain copy = d;
+    copy.clearFormulas();
+    copy.addFormula(ELSentence(getAsSentence("Q(a)"), 1.0));
+    BOOST_CHECK_EQUAL(copy.atomId(pa).get(), p);
+    BOOST_CHECK(copy.formulasWithAtom(p).empty());
+    BOOST_CHECK_EQUAL(copy.formulasWithAtom(q).size(), 1);
+    BOOST_CHECK_EQUAL(d.formulasWithAtom(q).size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE( formulaProgramTest ) {
+    boost::mt19937 rng;
+    const char* forms[] = {"P(a) ; Q(a)", "[ P(a) v !Q(a) ]", "<>{m} Q(a) -> P(a)",
+            "!(P(a) ^{o} R(a))", "<>{mi} [ P(a) ^ !R(a) ]", "false"};
+    Domain d = domainWithFormulas("P(a) @ [1:4]\nQ(a) @ [3:8]\nR(a) @ [6:12]\n", forms, 6);
+    BOOST_CHECK_EQUAL(d.formulaProgram(0).size(), 3);
+    BOOST_CHECK(d.formulaProgram(5).sentence() == d.formulas_begin()[5].sentence());
+
+    SentenceProgram::Registers regs;
+    ThreadPool pool(3);
+    for (int trial = 0; trial < 20; trial++) {
+        Model m = d.randomModel(rng);
+        double total = 0.0;
+        for (std::size_t i = 0; i < d.formulas_size(); i++) {
+            const ELSentence& f = d.formulas_begin()[i];
+            if (i == 0) {
+                // the program merges the span intervals of a ";" chain
+                // nothing else composes, so only the intervals are the same
+                BOOST_CHECK(equalByInterval(d.formulaProgram(i).dSatisfied(m, d, regs),
+                        f.sentence()->dSatisfied(m, d)));
+            } else {
+                BOOST_CHECK_EQUAL(d.formulaProgram(i).dSatisfied(m, d, regs),
+                        f.sentence()->dSatisfied(m, d));
+            }
+            BOOST_CHECK_EQUAL(d.score(i, m, regs), d.score(f, m));
+            total += d.score(f, m);
+
+            SISet where(false, d.maxInterval());
+            where.add(SpanInterval(2, 5, 4, 9));
+            BOOST_CHECK(equalByInterval(d.formulaProgram(i).dSatisfied(m, d, where, regs),
+                    f.sentence()->dSatisfied(m, d, where)));
+            SentenceProgram::Count count = d.formulaProgram(i).count(m, d, &where, regs);
+            BOOST_CHECK_EQUAL(count.satisfied, f.sentence()->dSatisfied(m, d, where).size());
+            BOOST_CHECK_EQUAL(count.total, where.size());
+            BOOST_CHECK_EQUAL(d.formulaProgram(i).fullySatisfied(m, d, &where, regs), count.fullySatisfied());
+            BOOST_CHECK_EQUAL(f.fullySatisfied(m, d),
+                    d.formulaProgram(i).count(m, d, NULL, regs).fullySatisfied());
+            BOOST_CHECK_EQUAL(d.isFullySatisfied(i, m, regs), f.fullySatisfied(m, d));
+        }
+        BOOST_CHECK_EQUAL(d.score(m), total);
+        BOOST_CHECK_EQUAL(d.score(m, pool), d.score(m));
+        BOOST_CHECK_EQUAL(d.formulaProgram(5).count(m, d, NULL, regs).satisfied, 0);
+    }
+
+    // cached evaluation reuses results until an atom of the subformula changes
+    SentenceProgram::Cache cache(64);
+    Model m = d.randomModel(rng);
+    const SentenceProgram& program = d.formulaProgram(3);    // !(P(a) ^{o} R(a))
+    SISet expected = program.dSatisfied(m, d, regs);
+    BOOST_CHECK_EQUAL(program.dSatisfied(m, d, regs, cache), expected);
+    int cached = cache.size();
+    BOOST_CHECK_EQUAL(cached, 2);
+    BOOST_CHECK_EQUAL(program.dSatisfied(m, d, regs, cache), expected);
+    BOOST_CHECK_EQUAL(cache.size(), cached);
+
+    Atom ra = *boost::dynamic_pointer_cast<Atom>(getAsSentence("R(a)"));
+    m.setAtom(ra, SISet(SpanInterval(1,3), true, d.maxInterval()));
+    BOOST_CHECK_EQUAL(program.dSatisfied(m, d, regs, cache), program.dSatisfied(m, d, regs));
+    BOOST_CHECK_EQUAL(cache.size(), cached+2);
+}
+
+BOOST_AUTO_TEST_CASE( sequenceProgramTest ) {
+    boost::mt19937 rng;
+    const char* forms[] = {"P(a) ; Q(a) ; R(a) ; P(a)"};
+    Domain d = domainWithFormulas("P(a) @ [1:4]\nQ(a) @ [3:8]\nR(a) @ [6:12]\n", forms, 1);
+    BOOST_CHECK_EQUAL(d.formulaProgram(0).size(), 5);
+
+    const char* names[] = {"P(a)", "Q(a)", "R(a)", "P(a)"};
+    std::set<Interval::INTERVAL_RELATION> meets;
+    meets.insert(Interval::MEETS);
+    SentenceProgram::Registers regs;
+    for (int trial = 0; trial < 20; trial++) {
+        Model m = d.randomModel(rng);
+        // the chain gives the same intervals as composing it a pair at a time
+        SISet nested(false, d.maxInterval());
+        for (int i = 0; i < 4; i++) {
+            boost::shared_ptr<Sentence> atom = getAsSentence(names[i]);
+            SISet sat = atom->satisfied(m, d, false);
+            nested = (i == 0 ? sat : composedOf(nested, sat, meets, d.maxSpanInterval()));
+        }
+        SISet sat = d.formulaProgram(0).satisfied(m, d, regs);
+        BOOST_CHECK(equalByInterval(sat, nested));
+        BOOST_CHECK(equalByInterval(d.formulas_begin()[0].sentence()->satisfied(m, d, false), nested));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( sequenceUnderRelationTest ) {
+    boost::mt19937 rng;
+    const char* forms[] = {"(!P(a) ; R(a)) ^{di} R(a)", "(!R(a) ; !Q(a)) ^{di} P(a)", "<>{oi} (!P(a) ; Q(a))"};
+    Domain d = domainWithFormulas("P(a) @ [1:4]\nQ(a) @ [3:8]\nR(a) @ [6:12]\n", forms, 3);
+
+    std::set<Interval::INTERVAL_RELATION> meets, di;
+    meets.insert(Interval::MEETS);
+    di.insert(Interval::DURINGI);
+    SpanInterval universe = d.maxSpanInterval();
+    SentenceProgram::Registers regs;
+    for (int trial = 0; trial < 20; trial++) {
+        Model m = (trial == 0 ? d.defaultModel() : d.randomModel(rng));
+        SISet p = getAsSentence("P(a)")->satisfied(m, d, false);
+        SISet q = getAsSentence("Q(a)")->satisfied(m, d, false);
+        SISet r = getAsSentence("R(a)")->satisfied(m, d, false);
+        SISet notP = getAsSentence("!P(a)")->satisfied(m, d, false);
+        SISet notQ = getAsSentence("!Q(a)")->satisfied(m, d, false);
+        SISet notR = getAsSentence("!R(a)")->satisfied(m, d, false);
+
+        // a chain composed by a relation or diamond is composed a pair at a
+        // time; sequenceOf()'s merged span intervals compose differently
+        std::vector<SISet> pairwise;
+        pairwise.push_back(composedOf(composedOf(notP, r, meets, universe), r, di, universe));
+        pairwise.push_back(composedOf(composedOf(notR, notQ, meets, universe), p, di, universe));
+        SISet chain = composedOf(notP, q, meets, universe);
+        pairwise.push_back(SISet(false, d.maxInterval()));
+        for (SISet::const_iterator it = chain.begin(); it != chain.end(); it++) {
+            boost::optional<SpanInterval> sp = it->satisfiesRelation(Interval::OVERLAPSI, universe);
+            if (sp) pairwise.back().add(*sp);
+        }
+
+        for (std::size_t i = 0; i < 3; i++) {
+            BOOST_CHECK(equalByInterval(d.formulaProgram(i).satisfied(m, d, regs), pairwise[i]));
+            BOOST_CHECK(equalByInterval(d.formulas_begin()[i].sentence()->satisfied(m, d, false), pairwise[i]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( deltaEvaluationTest ) {
+    boost::mt19937 rng;
+    const char* forms[] = {"[ P(a) v !Q(a) ]", "<>{m} Q(a) -> P(a)", "<>{mi,<} [ P(a) ^ !R(a) ]",
+            "P(a) ^{=} !Q(a)", "P(a) ; Q(a)"};
+    Domain d = domainWithFormulas("P(a) @ [1:10]\nQ(a) @ [8:20]\nR(a) @ [15:30]\n", forms, 5);
+    // composedOf() isn't exact, so meets conjunctions are always evaluated whole
+    BOOST_CHECK(d.formulaProgram(2).hasDelta());
+    BOOST_CHECK(!d.formulaProgram(4).hasDelta());
+
+    Atom pa = *boost::dynamic_pointer_cast<Atom>(getAsSentence("P(a)"));
+    Atom qa = *boost::dynamic_pointer_cast<Atom>(getAsSentence("Q(a)"));
+    SISet where(SpanInterval(5, 25, 5, 25), false, d.maxInterval());
+    SentenceProgram::Registers regs;
+    for (int trial = 0; trial < 20; trial++) {
+        Model before = d.randomModel(rng);
+        Move move;
+        move.add(d, pa, SpanInterval(3+trial, 6+trial));
+        move.del(d, qa, SpanInterval(12, 14+trial%5));
+        Model after = executeMove(d, move, before);
+        for (std::size_t i = 0; i < 4; i++) {
+            const SentenceProgram& program = d.formulaProgram(i);
+            SISet previous = program.dSatisfied(before, d, where, regs);
+            SISet delta = program.dSatisfiedDelta(after, d, where, previous, move, regs);
+            SISet full = program.dSatisfied(after, d, where, regs);
+            BOOST_CHECK_EQUAL(delta.size(), full.size());
+            BOOST_CHECK(equalByInterval(delta, full));
+            // and against the tree walk, which doesn't share the program's code
+            SISet walked = d.formulas_begin()[i].sentence()->dSatisfied(after, d, where);
+            BOOST_CHECK_EQUAL(delta.size(), walked.size());
+            BOOST_CHECK(equalByInterval(delta, walked));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( sharedSubformulaTest ) {
+    Domain d;
+    d.addFormula(ELSentence(getAsSentence("!Spike(b) v BallContact(a)"), 1.0));
+    d.addFormula(ELSentence(getAsSentence("!Spike(b) ^ <>{m} BallContact(a)"), 1.0));
+    d.addFormula(ELSentence(getAsSentence("!Spike(b) ^ <>{mi} BallContact(a)"), 1.0));
+
+    boost::shared_ptr<const Disjunction> dis = boost::dynamic_pointer_cast<const Disjunction>(d.formulas_begin()[0].sentence());
+    boost::shared_ptr<const Conjunction> con1 = boost::dynamic_pointer_cast<const Conjunction>(d.formulas_begin()[1].sentence());
+    boost::shared_ptr<const Conjunction> con2 = boost::dynamic_pointer_cast<const Conjunction>(d.formulas_begin()[2].sentence());
+    BOOST_REQUIRE(dis && con1 && con2);
+    BOOST_CHECK(dis->left() == con1->left());
+    BOOST_CHECK(con1->left() == con2->left());
+    // diamonds over different relations aren't the same subformula
+    BOOST_CHECK(con1->right() != con2->right());
+    BOOST_CHECK(*con1->right() != *con2->right());
+    BOOST_CHECK_EQUAL(d.formulas_begin()[1].sentence()->toString(), "!Spike(b) ^ <>{m} BallContact(a)");
+
+    // interning is idempotent, and survives a copy
+    SentenceInterner interner;
+    boost::shared_ptr<Sentence> s = getAsSentence("!Spike(b) v BallContact(a)");
+    boost::shared_ptr<Sentence> interned = interner.intern(s);
+    BOOST_CHECK(interner.intern(interned) == interned);
+    BOOST_CHECK_EQUAL(interner.size(), 4);
+    Domain copy = d;
+    copy.addFormula(ELSentence(s, 2.0));
+    BOOST_CHECK(copy.formulas_begin()[3].sentence() == d.formulas_begin()[0].sentence());
+    // even once the copy's core is detached from d's
+    copy.setMaxInterval(Interval(1, 20));
+    copy.addFormula(ELSentence(getAsSentence("!Spike(b) v BallContact(a)"), 3.0));
+    BOOST_CHECK(copy.formulas_begin()[4].sentence() == d.formulas_begin()[0].sentence());
+
+    // the table keeps its own copy of new nodes, so changing the sentence
+    // that was interned doesn't change the interned one
+    SentenceInterner fresh;
+    boost::shared_ptr<Disjunction> mine = boost::dynamic_pointer_cast<Disjunction>(getAsSentence("P(a) v Q(a)"));
+    boost::shared_ptr<Sentence> theirs = fresh.intern(mine);
+    BOOST_CHECK(theirs != mine);
+    mine->setLeft(getAsSentence("R(a)"));
+    BOOST_CHECK_EQUAL(theirs->toString(), "P(a) v Q(a)");
+    BOOST_CHECK(fresh.intern(getAsSentence("P(a) v Q(a)")) == theirs);
+}
+
+BOOST_AUTO_TEST_CASE( simplifyTest ) {
+    boost::mt19937 rng;
+    Domain d = domainWithFormulas("P(a) @ [1:4]\nQ(a) @ [3:8]\nR(a) @ [6:12]\n");
+    const char* forms[][2] = {
+            {"!!P(a) v false", "P(a)"},
+            {"P(a) ^ (Q(a) v true)", "P(a)"},
+            {"P(a) ; (Q(a) ^ false)", "false"},
+            {"<>{m} Q(a) v <>{o} Q(a)", "<>{m, o} Q(a)"},
+            {"(P(a) ^{m} Q(a)) v (P(a) ^{s} Q(a))", "P(a) ^{m, s} Q(a)"},
+            {"[ P(a) ^ P(a) ] v R(a)", "[ P(a) ] v R(a)"},
+            {"<>{=} !(R(a) v false)", "!R(a)"},
+            {"P(a) ; true", "P(a) ; true"},
+            {"[ !false ]", "[ true ]"}};
+    std::size_t n = sizeof(forms)/sizeof(forms[0]);
+    SentenceSimplifier simplifier;
+    std::vector<boost::shared_ptr<Sentence> > originals, simplified;
+    for (std::size_t i = 0; i < n; i++) {
+        originals.push_back(getAsSentence(forms[i][0]));
+        simplified.push_back(simplifier.simplify(originals.back()));
+        BOOST_CHECK_EQUAL(simplified.back()->toString(), forms[i][1]);
+    }
+    BOOST_CHECK_EQUAL(simplifier.eliminated(), 25);
+    // the input is left alone
+    BOOST_CHECK_EQUAL(originals[1]->toString(), "P(a) ^ (Q(a) v true)");
+    for (int trial = 0; trial < 20; trial++) {
+        Model m = d.randomModel(rng);
+        for (std::size_t i = 0; i < n; i++) {
+            BOOST_CHECK(equalByInterval(simplified[i]->dSatisfied(m, d), originals[i]->dSatisfied(m, d)));
+        }
+    }
+
+    // a tautology under a diamond is folded before the diamond is evaluated,
+    // so the diamond gets the result of <>{s} true, which (unlike the
+    // approximation over the spans of P and !P) includes [5:5]
+    boost::shared_ptr<Sentence> tautology = getAsSentence("<>{s} (P(a) -> P(a))");
+    boost::shared_ptr<Sentence> folded = simplifier.simplify(tautology);
+    BOOST_CHECK_EQUAL(folded->toString(), "<>{s} true");
+    Model m = d.defaultModel();
+    BOOST_CHECK(equalByInterval(folded->dSatisfied(m, d), getAsSentence("<>{s} true")->dSatisfied(m, d)));
+    BOOST_CHECK(folded->dSatisfied(m, d).includes(Interval(5, 5)));
+    BOOST_CHECK(!tautology->dSatisfied(m, d).includes(Interval(5, 5)));
+    // true isn't folded through a diamond
+    BOOST_CHECK_EQUAL(simplifier.simplify(getAsSentence("<>{m} true"))->toString(), "<>{m} true");
+
+    // tautologies aren't added to the domain
+    d.addFormula(ELSentence(getAsSentence("P(a) v !P(a)"), 1));
+    d.addFormula(ELSentence(getAsSentence("!!Q(a)"), 1));
+    BOOST_REQUIRE_EQUAL(d.formulas_size(), 1);
+    BOOST_CHECK_EQUAL(d.formulas_begin()->sentence()->toString(), "Q(a)");
+    BOOST_CHECK_EQUAL(d.eliminatedNodes(), 6);
+}
+
+BOOST_AUTO_TEST_CASE( pruneTest ) {
+    boost::mt19937 rng;
+    ParseOptions options;
+    options.setAssumeClosedWorldInFacts(true);
+    Domain d = loadDomainWithStreams("D-P(a) @ [1:4]\nQ(a) @ [3:8]\n", "", options);
+    d.addFormula(ELSentence(getAsSentence("!D-P(a) v P(a)"), 1));
+    d.addFormula(ELSentence(getAsSentence("[ Q(a) v D-P(a) ]"), 2));
+    d.addFormula(ELSentence(getAsSentence("<>{m} Q(a) -> P(a)"), 3));
+    d.addFormula(ELSentence(getAsSentence("P(a) ; !P(a)"), 4));
+
+    Domain pruned = d.pruneFormulas();
+    BOOST_REQUIRE_EQUAL(pruned.formulas_size(), 3);
+    BOOST_CHECK_EQUAL(pruned.formulas_begin()[0].quantification().toString(), "{[1:4]}");
+    BOOST_CHECK(pruned.formulas_begin()[1].isQuantified());
+    // some intervals are too short to hold a sequence
+    BOOST_CHECK(pruned.formulas_begin()[2].quantification().size() < d.maxSpanInterval().size());
+
+    // only a constant is taken off the score of models agreeing with the facts
+    Model m = d.randomModel(rng);
+    double offset = d.score(m) - pruned.score(m);
+    SentenceProgram::Registers regs;
+    for (int trial = 0; trial < 20; trial++) {
+        m = d.randomModel(rng);
+        BOOST_CHECK_CLOSE(d.score(m) - pruned.score(m), offset, 0.0001);
+        // the quantified formulas give the same through their programs
+        for (std::size_t i = 0; i < pruned.formulas_size(); i++) {
+            const ELSentence& f = pruned.formulas_begin()[i];
+            BOOST_CHECK(equalByInterval(pruned.dSatisfied(i, m, regs), f.dSatisfied(m, pruned)));
+            BOOST_CHECK(equalByInterval(pruned.dNotSatisfied(i, m, regs), f.dNotSatisfied(m, pruned)));
+        }
+    }
+
+    d.setDontModifyObsPreds(false);
+    BOOST_CHECK_EQUAL(d.pruneFormulas().formulas_size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE( templateBatchTest ) {
+    boost::mt19937 rng;
+    const char* forms[] = {"P(a) ; Q(a)", "[ P(a) v !Q(a) ]", "P(b) ; Q(b)",
+            "<>{m} Q(a) -> P(a)", "P(c) ; Q(c)", "[ P(c) v !Q(c) ]", "P(a) ; P(a)"};
+    Domain d = domainWithFormulas("P(a) @ [1:4]\nQ(b) @ [3:8]\nP(c) @ [6:12]\n", forms, 7);
+    BOOST_REQUIRE_EQUAL(d.formulaTemplates().size(), 4);
+    BOOST_CHECK_EQUAL(d.formulaTemplates()[0].size(), 3);
+    BOOST_CHECK_EQUAL(d.formulaTemplates()[0][2], 4);
+    BOOST_CHECK_EQUAL(d.formulaTemplates()[1].size(), 2);
+    // reading an atom twice isn't the same shape as reading two atoms
+    BOOST_CHECK(!d.formulaProgram(0).sameShape(d.formulaProgram(6)));
+
+    SISet where(false, d.maxInterval());
+    where.add(SpanInterval(2, 5, 4, 9));
+    std::vector<const SentenceProgram*> batch;
+    std::vector<const SISet*> wheres;
+    for (std::size_t j = 0; j < d.formulaTemplates()[0].size(); j++) {
+        batch.push_back(&d.formulaProgram(d.formulaTemplates()[0][j]));
+        wheres.push_back(j == 1 ? &where : NULL);
+    }
+    SentenceProgram::Registers regs;
+    std::vector<SentenceProgram::Registers> batchRegs;
+    std::vector<SentenceProgram::Count> counts;
+    for (int trial = 0; trial < 20; trial++) {
+        Model m = d.randomModel(rng);
+        SentenceProgram::countBatch(batch, m, d, wheres, batchRegs, counts);
+        for (std::size_t j = 0; j < batch.size(); j++) {
+            SentenceProgram::Count count = batch[j]->count(m, d, wheres[j], regs);
+            BOOST_CHECK_EQUAL(counts[j].satisfied, count.satisfied);
+            BOOST_CHECK_EQUAL(counts[j].total, count.total);
+        }
+        double total = 0.0;
+        for (std::size_t i = 0; i < d.formulas_size(); i++) total += d.score(i, m, regs);
+        BOOST_CHECK_EQUAL(d.score(m), total);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( cardinalityTest ) {
+    boost::mt19937 rng;
+    const char* forms[] = {"ex1(P(a), Q(a), R(a))", "[ at1(P(a), R(a)) ]", "at1(Q(a))"};
+    Domain d = domainWithFormulas("P(a) @ [1:4]\nQ(a) @ [3:8]\nR(a) @ [6:12]\n", forms, 3);
+    d.setMaxInterval(Interval(1, 15));
+    // at most one of a single atom always holds
+    BOOST_REQUIRE_EQUAL(d.formulas_size(), 2);
+    BOOST_CHECK_EQUAL(d.formulas_begin()->sentence()->toString(), "ex1(P(a), Q(a), R(a))");
+
+    boost::shared_ptr<Sentence> ex1 = getAsSentence("ex1(P(a), Q(a), R(a))");
+    boost::shared_ptr<Sentence> at1 = getAsSentence("at1(P(a), Q(a), R(a))");
+    BOOST_CHECK_EQUAL(ex1->dSatisfied(d.defaultModel(), d).toString(), "{[1:2], [5:5], [9:12]}");
+    BOOST_CHECK_EQUAL(at1->dSatisfied(d.defaultModel(), d).toString(), "{[1:2], [5:5], [9:15]}");
+
+    // the same as writing them out by hand
+    boost::shared_ptr<Sentence> ex1Expanded = getAsSentence("[ (P(a) ^ !Q(a) ^ !R(a)) v (!P(a) ^ Q(a) ^ !R(a)) v (!P(a) ^ !Q(a) ^ R(a)) ]");
+    boost::shared_ptr<Sentence> at1Expanded = getAsSentence("[ (P(a) ^ !Q(a) ^ !R(a)) v (!P(a) ^ Q(a) ^ !R(a)) v (!P(a) ^ !Q(a) ^ R(a)) v (!P(a) ^ !Q(a) ^ !R(a)) ]");
+    SentenceProgram::Registers regs;
+    for (int trial = 0; trial < 20; trial++) {
+        Model m = d.randomModel(rng);
+        BOOST_CHECK(equalByInterval(ex1->dSatisfied(m, d), ex1Expanded->dSatisfied(m, d)));
+        BOOST_CHECK(equalByInterval(at1->dSatisfied(m, d), at1Expanded->dSatisfied(m, d)));
+        BOOST_CHECK(equalByInterval(d.formulaProgram(0).dSatisfied(m, d, regs), ex1->dSatisfied(m, d)));
+    }
+}
+
+namespace {
+    // evaluates every formula of a domain the way scoring does, counting
+    // the results that differ from the ones computed on a single thread
+    struct EvaluateAll {
+        const Domain* d;
+        const Model* m;
+        const std::vector<SISet>* expected;
+        const std::vector<std::string>* names;
+        std::vector<SentenceProgram::Registers>* regs;
+        std::vector<int>* wrong;
+
+        void operator()(std::size_t worker, std::size_t item) const {
+            int count = 0;
+            for (std::size_t i = 0; i < d->formulas_size(); i++) {
+                const ELSentence& f = d->formulas_begin()[i];
+                if (!equalByInterval(d->formulaProgram(i).dSatisfied(*m, *d, (*regs)[worker]), (*expected)[i])) count++;
+                if (!equalByInterval(f.sentence()->dSatisfied(*m, *d), (*expected)[i])) count++;
+                if (f.sentence()->toString() != (*names)[i]) count++;
+                if (d->score(i, *m, (*regs)[worker]) != (*expected)[i].size() * f.weight()) count++;
+            }
+            (*wrong)[item] = count;
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE( concurrentEvaluationTest ) {
+    boost::mt19937 rng;
+    const char* forms[] = {"P(a) ; Q(a)", "[ P(a) v !Q(a) ]", "<>{m} Q(a) -> P(a)", "!(P(a) ^{o} R(a))",
+            "<>{mi} [ P(a) ^ !R(a) ]", "<>{d,s} P(a)", "<> (Q(a) ^ R(a))", "P(a) v Q(a) v !R(a)"};
+    Domain d = domainWithFormulas("P(a) @ [1:10]\nQ(a) @ [5:20]\nR(a) @ [15:30]\n", forms, 8);
+    Model m = d.randomModel(rng);
+
+    std::vector<SISet> expected;
+    std::vector<std::string> names;
+    for (Domain::formula_const_iterator it = d.formulas_begin(); it != d.formulas_end(); it++) {
+        expected.push_back(it->sentence()->dSatisfied(m, d));
+        names.push_back(it->sentence()->toString());
+    }
+
+    // many threads reading the same domain and model
+    ThreadPool pool(8);
+    std::vector<SentenceProgram::Registers> regs(pool.size());
+    std::vector<int> wrong(200, -1);
+    EvaluateAll task = {&d, &m, &expected, &names, &regs, &wrong};
+    pool.run(wrong.size(), task);
+    BOOST_CHECK_EQUAL(std::count(wrong.begin(), wrong.end(), 0), (int)wrong.size());
+    BOOST_CHECK_EQUAL(d.score(m, pool), d.score(m));
+}
+
 BOOST_AUTO_TEST_CASE( modelSerialization) {
     std::stringstream facts;
     facts << "P(a) @ [1:1]\n";
@@ -182,3 +182,44 @@ BOOST_AUTO_TEST_CASE( type_test ) {
             expectedArgs.begin(), expectedArgs.end());
 
 }
+
+BOOST_AUTO_TEST_CASE( typed_variable_test ) {
+    std::stringstream str("type: dogs = {fred, louie}\n"
+            "1: barks(?dogs:1) -> hungry(?dogs:1)\n"
+            "2: [ sniffs(?dogs:*, ?dogs:*) ^ rain() ]\n");
+    std::vector<FOLToken> tokens = FOLParse::tokenize(str);
+    std::vector<ELSentence> formulas;
+    FOLParse::parseFormulas(tokens.begin(), tokens.end(), formulas);
+
+    const std::vector<std::string> expected = boost::assign::list_of
+            ("1: !barks(fred) v hungry(fred) @ <everywhere>")
+            ("1: !barks(louie) v hungry(louie) @ <everywhere>")
+            ("2: [ sniffs(fred, fred) ^ rain() ] @ <everywhere>")
+            ("2: [ sniffs(fred, louie) ^ rain() ] @ <everywhere>")
+            ("2: [ sniffs(louie, fred) ^ rain() ] @ <everywhere>")
+            ("2: [ sniffs(louie, louie) ^ rain() ] @ <everywhere>");
+    BOOST_REQUIRE_EQUAL(formulas.size(), expected.size());
+    for (std::size_t i = 0; i < formulas.size(); i++) {
+        BOOST_CHECK_EQUAL(formulas[i].toString(), expected[i]);
+    }
+
+    // every ?type:* is a new variable, and the groundings share what has none
+    std::istringstream str2("sniffs(?dogs:*, ?dogs:2) ^ rain()");
+    tokens = FOLParse::tokenize(str2);
+    ELSentence lifted(FOLParse::parseFormula(tokens.begin(), tokens.end()));
+    BOOST_CHECK_EQUAL(lifted.sentence()->toString(), "sniffs(?dogs:3, ?dogs:2) ^ rain()");
+    std::map<std::string, std::set<std::string> > objTypes;
+    objTypes["dogs"] = boost::assign::list_of("fred")("louie")("speedy");
+    SentenceGrounder grounder(lifted, objTypes);
+    BOOST_CHECK_EQUAL(grounder.variables().size(), 2);
+    BOOST_CHECK_EQUAL(grounder.size(), 9);
+    ELSentence first, second;
+    BOOST_REQUIRE(grounder.next(first));
+    BOOST_REQUIRE(grounder.next(second));
+    BOOST_CHECK_EQUAL(second.sentence()->toString(), "sniffs(fred, louie) ^ rain()");
+    BOOST_CHECK(boost::static_pointer_cast<Conjunction>(first.sentence())->right()
+            == boost::static_pointer_cast<Conjunction>(second.sentence())->right());
+    int rest = 0;
+    while (grounder.next(first)) rest++;
+    BOOST_CHECK_EQUAL(rest, 7);
+}
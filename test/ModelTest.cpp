@@ -23,3 +23,83 @@
 BOOST_AUTO_TEST_CASE(basicModelTest) {
 
 }
+
+BOOST_AUTO_TEST_CASE(fingerprintTest) {
+    Interval maxInt(1, 10);
+    Atom p("P");
+    Atom q("Q");
+    SISet pSet(true, maxInt);
+    pSet.add(SpanInterval(1, 5));
+    SISet qSet(false, maxInt);
+    qSet.add(SpanInterval(3, 3, 7, 7));
+
+    Model empty(maxInt);
+    BOOST_CHECK(empty.fingerprint() == 0);
+
+    // insertion order doesn't matter
+    Model a(maxInt), b(maxInt);
+    a.setAtom(p, pSet);
+    a.setAtom(q, qSet);
+    b.setAtom(q, qSet);
+    b.setAtom(p, pSet);
+    BOOST_CHECK_EQUAL(a.fingerprint(), b.fingerprint());
+    BOOST_CHECK_EQUAL(hash_value(a), hash_value(b));
+    BOOST_CHECK(a == b);
+
+    // undoing a change restores the fingerprint
+    Model c = a;
+    SISet extra(true, maxInt);
+    extra.add(SpanInterval(8, 9));
+    c.setAtom(p, extra);
+    BOOST_CHECK(c.fingerprint() != a.fingerprint());
+    BOOST_CHECK(c != a);
+    c.unsetAtom(p, extra);
+    BOOST_CHECK_EQUAL(c.fingerprint(), a.fingerprint());
+    BOOST_CHECK(c == a);
+
+    c.clearAtom(q);
+    c.clearAtom(p);
+    BOOST_CHECK_EQUAL(c.fingerprint(), empty.fingerprint());
+
+    // a model rebuilt from scratch agrees with the incremental one
+    Model d(maxInt);
+    d.setAtom(p, pSet);
+    d.setAtom(q, qSet);
+    d.setMaxInterval(maxInt);
+    BOOST_CHECK_EQUAL(d.fingerprint(), a.fingerprint());
+}
+
+BOOST_AUTO_TEST_CASE(atomVersionTest) {
+    Interval maxInt(1, 10);
+    Atom p("P");
+    Atom q("Q");
+    SISet pSet(true, maxInt);
+    pSet.add(SpanInterval(1, 5));
+
+    Model a(maxInt);
+    BOOST_CHECK(a.atomVersion(p) == 0);
+    a.setAtom(p, pSet);
+    a.setAtom(q, pSet);
+    boost::uint64_t pVersion = a.atomVersion(p);
+    BOOST_CHECK(pVersion != 0);
+    BOOST_CHECK(a.atomVersion(q) != pVersion);
+
+    // copies keep their versions until they diverge
+    Model b = a;
+    BOOST_CHECK_EQUAL(b.atomVersion(p), pVersion);
+    Model c = a;
+    SISet extra(true, maxInt);
+    extra.add(SpanInterval(8, 9));
+    b.setAtom(p, extra);
+    c.setAtom(p, extra);
+    BOOST_CHECK(b.atomVersion(p) != pVersion);
+    BOOST_CHECK(b.atomVersion(p) != c.atomVersion(p));
+    BOOST_CHECK_EQUAL(b.atomVersion(q), a.atomVersion(q));
+
+    b.unsetAtom(p, extra);
+    BOOST_CHECK(b.atomVersion(p) != pVersion);
+    b.unsetAtom(p, pSet);
+    BOOST_CHECK(b.atomVersion(p) == 0);
+    c.clearAtom(q);
+    BOOST_CHECK(c.atomVersion(q) == 0);
+}
@@ -53,7 +53,7 @@ BOOST_AUTO_TEST_CASE(liquidLitMovesTest) {
     moves = findMovesFor(d, d.defaultModel(), form1, rng);
     BOOST_REQUIRE_EQUAL(moves.size(), 1);
     move = moves[0];
-    BOOST_CHECK_EQUAL(move.toString(), "toAdd: {Q(a, b) @ [1:5]}, toDel: {}");
+    BOOST_CHECK_EQUAL(move.toString(d), "toAdd: {Q(a, b) @ [1:5]}, toDel: {}");
 
     moves = findMovesFor(d, d.defaultModel(), form2, rng);
     BOOST_CHECK_EQUAL(moves.size(), 0);
@@ -61,12 +61,12 @@ BOOST_AUTO_TEST_CASE(liquidLitMovesTest) {
     moves = findMovesFor(d, d.defaultModel(), form3, rng);
     BOOST_REQUIRE_EQUAL(moves.size(), 1);
     move = moves[0];
-    BOOST_CHECK_EQUAL(move.toString(), "toAdd: {}, toDel: {P(a, b) @ [1:5]}");
+    BOOST_CHECK_EQUAL(move.toString(d), "toAdd: {}, toDel: {P(a, b) @ [1:5]}");
 
     moves = findMovesFor(d, d.defaultModel(), form4, rng);
     BOOST_REQUIRE_EQUAL(moves.size(), 1);
     move = moves[0];
-    BOOST_CHECK_EQUAL(move.toString(), "toAdd: {S(a) @ [5:5]}, toDel: {}");
+    BOOST_CHECK_EQUAL(move.toString(d), "toAdd: {S(a) @ [5:5]}, toDel: {}");
 }
 
 BOOST_AUTO_TEST_CASE(liquidConjMovesTest) {
@@ -83,7 +83,7 @@ BOOST_AUTO_TEST_CASE(liquidConjMovesTest) {
 
     Move move;
     move = findMovesFor(d, d.defaultModel(), form1, rng)[0];
-    BOOST_CHECK_EQUAL(move.toString(), "toAdd: {P(a, b) @ [6:10]}, toDel: {S(a) @ [6:10]}" );
+    BOOST_CHECK_EQUAL(move.toString(d), "toAdd: {P(a, b) @ [6:10]}, toDel: {S(a) @ [6:10]}" );
 }
 
 BOOST_AUTO_TEST_CASE(liquidDisjMovesTest) {
@@ -99,11 +99,44 @@ BOOST_AUTO_TEST_CASE(liquidDisjMovesTest) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), form1, rng);
     BOOST_REQUIRE_EQUAL(moves.size(), 2);
-    BOOST_CHECK_EQUAL(moves[0].toString(), "toAdd: {}, toDel: {P(a, b) @ [3:5]}" );
-    BOOST_CHECK_EQUAL(moves[1].toString(), "toAdd: {S(a) @ [3:5]}, toDel: {}" );
+    BOOST_CHECK_EQUAL(moves[0].toString(d), "toAdd: {}, toDel: {P(a, b) @ [3:5]}" );
+    BOOST_CHECK_EQUAL(moves[1].toString(d), "toAdd: {S(a) @ [3:5]}, toDel: {}" );
 
 }
 
+BOOST_AUTO_TEST_CASE(cardinalityMovesTest) {
+    std::string facts("P(a) @ [1:5]\n"
+            "S(a) @ [3:10]\n");
+    Domain d = loadDomainWithStreams(facts, "");
+    d.setDontModifyObsPreds(false);
+    d.addFormula(ELSentence(getAsSentence("ex1(P(a), S(a))"), 1));
+    d.addFormula(ELSentence(getAsSentence("at1(P(a), S(a))"), 1));
+    std::vector<ELSentence> formSet(d.formulas_begin(), d.formulas_end());
+    boost::mt19937 rng;
+
+    std::vector<Move> moves = findMovesFor(d, d.defaultModel(), formSet.at(0), rng);
+    BOOST_REQUIRE_EQUAL(moves.size(), 2);
+    BOOST_CHECK_EQUAL(moves[0].toString(d), "toAdd: {P(a) @ [3:5]}, toDel: {S(a) @ [3:5]}");
+    BOOST_CHECK_EQUAL(moves[1].toString(d), "toAdd: {S(a) @ [3:5]}, toDel: {P(a) @ [3:5]}");
+
+    moves = findMovesFor(d, d.defaultModel(), formSet.at(1), rng);
+    BOOST_REQUIRE_EQUAL(moves.size(), 3);
+    BOOST_CHECK_EQUAL(moves[0].toString(d), "toAdd: {}, toDel: {S(a) @ [3:5]}");
+    BOOST_CHECK_EQUAL(moves[2].toString(d), "toAdd: {}, toDel: {P(a) @ [3:5], S(a) @ [3:5]}");
+    Model fixed = executeMove(d, moves[0], d.defaultModel());
+    BOOST_CHECK_EQUAL(formSet.at(1).dNotSatisfied(fixed, d).size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(moveGeneratorKindTest) {
+    Domain d = loadDomainWithStreams("P(a) @ [1:5]\nS(a) @ [3:10]\n", "");
+    BOOST_CHECK_EQUAL(MoveGenerator(*getAsSentence("[P(a) ^ S(a)]"), d).kind(), MoveGenerator::LIQUID);
+    BOOST_CHECK_EQUAL(MoveGenerator(*getAsSentence("ex1(P(a), S(a))"), d).kind(), MoveGenerator::CARDINALITY);
+    BOOST_CHECK_EQUAL(MoveGenerator(*getAsSentence("!P(a)"), d).kind(), MoveGenerator::PELCNF_LITERAL);
+    BOOST_CHECK_EQUAL(MoveGenerator(*getAsSentence("P(a) v !S(a)"), d).kind(), MoveGenerator::PELCNF_DISJUNCTION);
+    BOOST_CHECK(!MoveGenerator(*getAsSentence("P(a) ^{mi} !(S(a) v P(a))"), d).canFindMoves());
+    BOOST_CHECK(!MoveGenerator().canFindMoves());
+}
+
 BOOST_AUTO_TEST_CASE(pelCNFAtomTest) {
     std::string facts("P(a,b) @ [1:5]\n"
             "S(a) @ [1:2]\n");
@@ -117,7 +150,7 @@ BOOST_AUTO_TEST_CASE(pelCNFAtomTest) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), form1, rng);
     BOOST_CHECK_EQUAL(moves.size(), 1);
-    BOOST_CHECK_EQUAL(moves[0].toString(), "toAdd: {S(a) @ [3:5]}, toDel: {}");
+    BOOST_CHECK_EQUAL(moves[0].toString(d), "toAdd: {S(a) @ [3:5]}, toDel: {}");
 }
 
 BOOST_AUTO_TEST_CASE(pelCNFNegAtomTest) {
@@ -132,7 +165,7 @@ BOOST_AUTO_TEST_CASE(pelCNFNegAtomTest) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), form1, rng);
     BOOST_REQUIRE_EQUAL(moves.size(), 1);
-    BOOST_CHECK_EQUAL(moves[0].toString(), "toAdd: {}, toDel: {S(a) @ [1:2]}");
+    BOOST_CHECK_EQUAL(moves[0].toString(d), "toAdd: {}, toDel: {S(a) @ [1:2]}");
 }
 
 BOOST_AUTO_TEST_CASE(pelCNFDisjunctionTest) {
@@ -149,8 +182,8 @@ BOOST_AUTO_TEST_CASE(pelCNFDisjunctionTest) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), form1, rng);
     BOOST_REQUIRE_EQUAL(moves.size(), 2);
-    BOOST_CHECK_EQUAL(moves[0].toString(), "toAdd: {P(a, b) @ [6:10]}, toDel: {}");
-    BOOST_CHECK_EQUAL(moves[1].toString(), "toAdd: {S(a) @ [6:10]}, toDel: {}");
+    BOOST_CHECK_EQUAL(moves[0].toString(d), "toAdd: {P(a, b) @ [6:10]}, toDel: {}");
+    BOOST_CHECK_EQUAL(moves[1].toString(d), "toAdd: {S(a) @ [6:10]}, toDel: {}");
 
 }
 
@@ -167,8 +200,8 @@ BOOST_AUTO_TEST_CASE(pelCNFDiamondTestTest) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), form1, rng);
     BOOST_CHECK_EQUAL(moves.size(), 2);
-    BOOST_CHECK_EQUAL(moves[0].toString(), "toAdd: {}, toDel: {Dig(a) @ [4:6], Spike(a) @ [4:6]}");
-    BOOST_CHECK_EQUAL(moves[1].toString(), "toAdd: {}, toDel: {Huddle(a) @ [2:2]}");
+    BOOST_CHECK_EQUAL(moves[0].toString(d), "toAdd: {}, toDel: {Dig(a) @ [4:6], Spike(a) @ [4:6]}");
+    BOOST_CHECK_EQUAL(moves[1].toString(d), "toAdd: {}, toDel: {Huddle(a) @ [2:2]}");
 }
 
 BOOST_AUTO_TEST_CASE(pelCNFDiamondConjTest) {
@@ -192,9 +225,9 @@ BOOST_AUTO_TEST_CASE(pelCNFDiamondConjTest) {
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), form1, rng);
     BOOST_REQUIRE_EQUAL(moves.size(), 3);
 
-    BOOST_CHECK_EQUAL(moves[0].toString(), "toAdd: {GoingUp(a) @ [4:4]}, toDel: {}");
-    BOOST_CHECK_EQUAL(moves[1].toString(), "toAdd: {}, toDel: {GoingDown(a) @ [3:3]}");
-    BOOST_CHECK_EQUAL(moves[2].toString(), "toAdd: {}, toDel: {GoingDown(a) @ [5:5]}");
+    BOOST_CHECK_EQUAL(moves[0].toString(d), "toAdd: {GoingUp(a) @ [4:4]}, toDel: {}");
+    BOOST_CHECK_EQUAL(moves[1].toString(d), "toAdd: {}, toDel: {GoingDown(a) @ [3:3]}");
+    BOOST_CHECK_EQUAL(moves[2].toString(d), "toAdd: {}, toDel: {GoingDown(a) @ [5:5]}");
 }
 
 BOOST_AUTO_TEST_CASE(pelCNFDisjLiqTest) {
@@ -239,7 +272,7 @@ BOOST_AUTO_TEST_CASE(maxWalkSatTestForm1mi) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), *d.formulas_begin(), rng);
     BOOST_FOREACH(Move move, moves) {
-        std::cout << "move: " << move.toString() << std::endl;
+        std::cout << "move: " << move.toString(d) << std::endl;
     }
 }
 
@@ -254,7 +287,7 @@ BOOST_AUTO_TEST_CASE(maxWalkSatTestForm1m) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), *d.formulas_begin(), rng);
     BOOST_FOREACH(Move move, moves) {
-        std::cout << "move: " << move.toString() << std::endl;
+        std::cout << "move: " << move.toString(d) << std::endl;
     }
 }
 
@@ -269,7 +302,7 @@ BOOST_AUTO_TEST_CASE(maxWalkSatTestForm1f) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), *d.formulas_begin(), rng);
     BOOST_FOREACH(Move move, moves) {
-        std::cout << "finish move: " << move.toString() << std::endl;
+        std::cout << "finish move: " << move.toString(d) << std::endl;
     }
 }
 
@@ -285,7 +318,7 @@ BOOST_AUTO_TEST_CASE(maxWalkSatTestForm1fi) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), *d.formulas_begin(), rng);
     BOOST_FOREACH(Move move, moves) {
-        std::cout << "finish move: " << move.toString() << std::endl;
+        std::cout << "finish move: " << move.toString(d) << std::endl;
     }
 }
 
@@ -302,7 +335,7 @@ BOOST_AUTO_TEST_CASE(maxWalkSatTestForm2) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), *d.formulas_begin(), rng);
     BOOST_FOREACH(Move move, moves) {
-        std::cout << "form2 move: " << move.toString() << std::endl;
+        std::cout << "form2 move: " << move.toString(d) << std::endl;
     }
 }
 
@@ -320,7 +353,7 @@ BOOST_AUTO_TEST_CASE(maxWalkSatTestForm3) {
 
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), *d.formulas_begin(), rng);
     BOOST_FOREACH(Move move, moves) {
-        std::cout << "form3 move: " << move.toString() << std::endl;
+        std::cout << "form3 move: " << move.toString(d) << std::endl;
     }
 }
 
@@ -336,6 +369,6 @@ BOOST_AUTO_TEST_CASE(diamondLessThan) {
     std::vector<Move> moves = findMovesFor(d, d.defaultModel(), *d.formulas_begin(), rng);
     BOOST_CHECK(moves.size()!=0);
     BOOST_FOREACH(Move m, moves) {
-        std::cout << "move = " << m.toString() << std::endl;
+        std::cout << "move = " << m.toString(d) << std::endl;
     }
 }
@@ -173,6 +173,110 @@ BOOST_AUTO_TEST_CASE( spanIntervalspan ) {
     */
 }
 
+BOOST_AUTO_TEST_CASE( siSetComposedOfTest ) {
+    Interval maxInterval(1, 60);
+    SpanInterval universe(maxInterval);
+    SISet a(false, maxInterval);
+    SISet b(false, maxInterval);
+    for (unsigned int i = 1; i < 55; i += 7) {
+        a.add(SpanInterval(i, i+3));
+        b.add(SpanInterval(i+2, i+2, i+4, i+5));
+    }
+    a.add(SpanInterval(2, 20, 30, 50));
+
+    std::vector<std::set<Interval::INTERVAL_RELATION> > relSets;
+    relSets.push_back(list_of(Interval::MEETS));
+    relSets.push_back(list_of(Interval::EQUALS));
+    relSets.push_back(list_of(Interval::OVERLAPS)(Interval::LESSTHAN)(Interval::DURINGI));
+    for (std::size_t i = 0; i < relSets.size(); i++) {
+        // same span intervals in the same order as composing every pair
+        SISet expected(false, maxInterval);
+        for (SISet::const_iterator aIt = a.begin(); aIt != a.end(); aIt++) {
+            for (SISet::const_iterator bIt = b.begin(); bIt != b.end(); bIt++) {
+                BOOST_FOREACH(Interval::INTERVAL_RELATION rel, relSets[i]) {
+                    expected.add(composedOf(*aIt, *bIt, rel, universe));
+                }
+            }
+        }
+        BOOST_CHECK_EQUAL(composedOf(a, b, relSets[i], universe).toString(), expected.toString());
+    }
+    BOOST_CHECK(composedOf(SISet(false, maxInterval), b, relSets[0], universe).empty());
+}
+
+BOOST_AUTO_TEST_CASE( siSetSequenceOfTest ) {
+    Interval maxInterval(1, 80);
+    SpanInterval universe(maxInterval);
+    std::set<Interval::INTERVAL_RELATION> meets = list_of(Interval::MEETS);
+    std::vector<SISet> parts(4, SISet(false, maxInterval));
+    for (unsigned int i = 1; i < 75; i += 5) {
+        parts[i % 4].add(SpanInterval(i, i+4));
+        parts[(i+1) % 4].add(SpanInterval(i, i+6));
+    }
+    parts[2].add(SpanInterval(3, 10, 20, 40));
+
+    SISet nested = parts[0];
+    for (std::size_t i = 1; i < parts.size(); i++) {
+        nested = composedOf(nested, parts[i], meets, universe);
+    }
+    SISet seq = sequenceOf(parts, universe);
+    BOOST_CHECK(equalByInterval(seq, nested));
+    BOOST_CHECK(seq.disjointSize() > 0);
+    BOOST_CHECK(std::distance(seq.begin(), seq.end()) < std::distance(nested.begin(), nested.end()));
+
+    parts[1] = SISet(false, maxInterval);
+    BOOST_CHECK(sequenceOf(parts, universe).empty());
+}
+
+BOOST_AUTO_TEST_CASE( siSetUnionIntersectionOfTest ) {
+    Interval maxInterval(1, 60);
+    SpanInterval universe(maxInterval);
+    std::vector<SISet> liquid(3, SISet(true, maxInterval));
+    liquid[0].add(SpanInterval(1, 10));
+    liquid[0].add(SpanInterval(20, 30));
+    liquid[1].add(SpanInterval(5, 25));
+    liquid[1].add(SpanInterval(40, 50));
+    liquid[2].add(SpanInterval(8, 22));
+    liquid[2].add(SpanInterval(26, 45));
+
+    SISet unioned = unionOf(liquid, true, maxInterval);
+    BOOST_CHECK_EQUAL(unioned.toString(), "{[1:50]}");
+    BOOST_CHECK(unioned.forceLiquid());
+    SISet intersected = intersectionOf(liquid, true, universe);
+    BOOST_CHECK_EQUAL(intersected.toString(), "{[8:10], [20:22]}");
+    BOOST_CHECK(intersected.forceLiquid());
+
+    // the same interval twice is only counted once
+    std::vector<SISet> twice(2, liquid[1]);
+    BOOST_CHECK_EQUAL(unionOf(twice, true, maxInterval).liqSize(), liquid[1].liqSize());
+
+    // non-liquid sets give the same intervals as adding or composing them
+    // a pair at a time
+    std::vector<SISet> nonLiquid(3, SISet(false, maxInterval));
+    SISet added(false, maxInterval);
+    for (std::size_t i = 0; i < liquid.size(); i++) {
+        nonLiquid[i] = liquid[i];
+        nonLiquid[i].setForceLiquid(false);
+        if (i == 1) nonLiquid[i].add(SpanInterval(2, 9, 12, 30));
+        added.add(nonLiquid[i]);
+    }
+    std::set<Interval::INTERVAL_RELATION> equals = list_of(Interval::EQUALS);
+    SISet composed = composedOf(composedOf(nonLiquid[0], nonLiquid[1], equals, universe), nonLiquid[2], equals, universe);
+    BOOST_CHECK_EQUAL(unionOf(nonLiquid, false, maxInterval), added);
+    BOOST_CHECK_EQUAL(intersectionOf(nonLiquid, false, universe), composed);
+
+    // negated operands give the same intervals as intersecting the compliment
+    std::vector<SISet> without(1, liquid[2]);
+    std::vector<SISet> first(liquid.begin(), liquid.begin()+2);
+    BOOST_CHECK_EQUAL(intersectionOf(first, without, true, universe).toString(), "{[5:7], [23:25]}");
+    BOOST_CHECK_EQUAL(intersectionOf(std::vector<SISet>(), without, true, universe).toString(),
+            liquid[2].compliment().toString());
+    without[0] = nonLiquid[2];
+    first.assign(nonLiquid.begin(), nonLiquid.begin()+2);
+    first.push_back(nonLiquid[2].compliment());
+    BOOST_CHECK(equalByInterval(intersectionOf(first, false, universe),
+            intersectionOf(std::vector<SISet>(nonLiquid.begin(), nonLiquid.begin()+2), without, false, universe)));
+}
+
 BOOST_AUTO_TEST_CASE( spanIntervalSize ) {
     SpanInterval sp1(5,10,5,10);
     SpanInterval sp2(1,5,3,6);
@@ -233,6 +337,13 @@ BOOST_AUTO_TEST_CASE( siSetComplimentTest) {
     BOOST_CHECK_EQUAL(set.toString(), "{[(1, 9), (1, 20)], [(10, 10), (10, 19)], [(10, 18), (20, 20)], [(11, 18), (11, 19)], [19:20]}");
     SISet compliment = set.compliment();
     BOOST_CHECK_EQUAL(compliment.toString(), "{}");
+
+    // still empty when the first span interval already covers everything
+    SISet covered(false, Interval(1, 16));
+    covered.add(SpanInterval(1, 16));
+    covered.add(SpanInterval(2, 16));
+    covered.add(SpanInterval(6, 8, 13, 14));
+    BOOST_CHECK_EQUAL(covered.compliment().toString(), "{}");
 }
 
 BOOST_AUTO_TEST_CASE ( siIteratorTest) {
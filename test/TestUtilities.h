@@ -9,6 +9,7 @@
 
 Domain loadDomainWithStreams(const std::string& facts, const std::string& formulas, const ParseOptions& options=ParseOptions());
 boost::shared_ptr<Sentence> getAsSentence(const std::string& str);
+Domain domainWithFormulas(const std::string& facts, const char* const forms[]=NULL, std::size_t n=0);
 
 boost::shared_ptr<Sentence> getAsSentence(const std::string& str) {
     std::istringstream stream(str);
@@ -59,4 +60,18 @@ Domain loadDomainWithStreams(const std::string& facts, const std::string& formul
     return d;
 }
 
+/**
+ * Loads the facts without assuming a closed world, then adds forms[0..n)
+ * as formulas, forms[i] with weight i+1 so their scores can be told apart.
+ */
+Domain domainWithFormulas(const std::string& facts, const char* const forms[], std::size_t n) {
+    ParseOptions options;
+    options.setAssumeClosedWorldInFacts(false);
+    Domain d = loadDomainWithStreams(facts, "", options);
+    for (std::size_t i = 0; i < n; i++) {
+        d.addFormula(ELSentence(getAsSentence(forms[i]), i+1));
+    }
+    return d;
+}
+
 #endif
@@ -0,0 +1,65 @@
+#define BOOST_TEST_MODULE ThreadPool
+#define BOOST_TEST_MAIN
+#include "../src/config.h"
+#ifdef USE_DYNAMIC_UNIT_TEST
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#else
+#include <boost/test/included/unit_test.hpp>
+#endif
+#include <vector>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+namespace {
+    struct Record {
+        std::vector<int>* runs;
+        std::vector<std::size_t>* workers;
+
+        void operator()(std::size_t worker, std::size_t item) const {
+            (*runs)[item]++;
+            (*workers)[item] = worker;
+        }
+    };
+
+    struct FailAt {
+        std::size_t item;
+
+        void operator()(std::size_t, std::size_t i) const {
+            if (i == item) throw std::invalid_argument("failed");
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE( runsEveryItemOnce ) {
+    for (std::size_t threads = 0; threads <= 4; threads++) {
+        ThreadPool pool(threads);
+        BOOST_CHECK_EQUAL(pool.size(), (threads == 0 ? 1 : threads));
+        // the pool is reused between runs
+        for (std::size_t n = 0; n < 50; n += 7) {
+            std::vector<int> runs(n, 0);
+            std::vector<std::size_t> workers(n, 0);
+            Record task = {&runs, &workers};
+            pool.run(n, task);
+            for (std::size_t i = 0; i < n; i++) {
+                BOOST_CHECK_EQUAL(runs[i], 1);
+                BOOST_CHECK(workers[i] < pool.size());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( passesOnErrors ) {
+    ThreadPool serial(1);
+    FailAt task = {3};
+    BOOST_CHECK_THROW(serial.run(10, task), std::invalid_argument);
+
+    ThreadPool pool(3);
+    BOOST_CHECK_THROW(pool.run(10, task), std::runtime_error);
+    // still usable afterwards
+    std::vector<int> runs(10, 0);
+    std::vector<std::size_t> workers(10, 0);
+    Record record = {&runs, &workers};
+    pool.run(10, record);
+    for (std::size_t i = 0; i < 10; i++) BOOST_CHECK_EQUAL(runs[i], 1);
+}